@@ -0,0 +1,95 @@
+#include "benchmark.h"
+
+#include <adaptive_mutex.h>
+#include <mutex_guarded.h>
+
+#include <shared_mutex>
+
+/**
+ * @file Compares the adaptive spin-then-park mutexes against their standard library counterparts.
+ * The level of contention is varied through the thread count and the critical section length;
+ * passing a thread count above the hardware concurrency (e.g., `--threads=64`) additionally
+ * exercises the parking path, since spinning is then mostly futile.
+ */
+
+namespace
+{
+// Long enough that the timed variants never actually time out.
+constexpr auto timeout = std::chrono::seconds{ 1 };
+
+template <typename MutexType>
+void benchmark_unique(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        auto proxy = data.lock();
+        if (is_read) {
+            bench::do_not_optimize(bench::read_work(*proxy, length));
+        } else {
+            bench::write_work(*proxy, length);
+        }
+    });
+
+    bench::report(options, "adaptive_mutex", name, workload, result);
+}
+
+template <typename MutexType>
+void benchmark_unique_and_timed(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        auto proxy = data.try_lock_for(timeout);
+        if (is_read) {
+            bench::do_not_optimize(bench::read_work(*proxy, length));
+        } else {
+            bench::write_work(*proxy, length);
+        }
+    });
+
+    bench::report(options, "adaptive_mutex", name + " try_lock_for()", workload, result);
+}
+
+template <typename MutexType>
+void benchmark_shared(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        if (is_read) {
+            const auto proxy = data.read_lock();
+            bench::do_not_optimize(bench::read_work(*proxy, length));
+        } else {
+            auto proxy = data.write_lock();
+            bench::write_work(*proxy, length);
+        }
+    });
+
+    bench::report(options, "adaptive_mutex", name, workload, result);
+}
+
+void run(const bench::options& options)
+{
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        benchmark_unique<std::mutex>(options, workload, "std::mutex");
+        benchmark_unique<adaptive_mutex>(options, workload, "adaptive_mutex");
+
+        benchmark_unique_and_timed<std::timed_mutex>(options, workload, "std::timed_mutex");
+        benchmark_unique_and_timed<adaptive_timed_mutex>(options, workload, "adaptive_timed_mutex");
+
+        benchmark_shared<std::shared_mutex>(options, workload, "std::shared_mutex");
+        benchmark_shared<std::shared_timed_mutex>(options, workload, "std::shared_timed_mutex");
+        benchmark_shared<adaptive_shared_timed_mutex>(
+            options, workload, "adaptive_shared_timed_mutex");
+    });
+}
+
+const bool registered = bench::register_suite("adaptive_mutex", run);
+} // namespace
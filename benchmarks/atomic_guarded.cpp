@@ -0,0 +1,60 @@
+#include "benchmark.h"
+
+#include <atomic_guarded.h>
+#include <mutex_guarded.h>
+
+#include <mutex>
+
+/**
+ * @file Compares the throughput of a word-sized counter guarded by an `atomic_guarded<...>`
+ * against one guarded by a plain `mutex_guarded<...>`. The atomic guard replaces every lock
+ * acquisition by a load, plus a compare-and-swap for writes, but has to retry writes whose copy
+ * went stale, so longer critical sections under heavy write contention favour the mutex.
+ */
+
+namespace
+{
+void benchmark_mutex_guarded(const bench::options& options, const bench::workload& workload)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, std::mutex> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        if (is_read) {
+            bench::do_not_optimize(data.with_lock_held(
+                [&](const std::uint64_t& value) { return bench::read_work(value, length); }));
+        } else {
+            data.with_lock_held([&](std::uint64_t& value) { bench::write_work(value, length); });
+        }
+    });
+
+    bench::report(options, "atomic", "mutex_guarded<..., std::mutex>", workload, result);
+}
+
+void benchmark_atomic_guarded(const bench::options& options, const bench::workload& workload)
+{
+    const auto length = workload.critical_section_length;
+
+    atomic_guarded<std::uint64_t> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        if (is_read) {
+            bench::do_not_optimize(data.with_lock_held(
+                [&](const std::uint64_t& value) { return bench::read_work(value, length); }));
+        } else {
+            data.with_lock_held([&](std::uint64_t& value) { bench::write_work(value, length); });
+        }
+    });
+
+    bench::report(options, "atomic", "atomic_guarded<...>", workload, result);
+}
+
+void run(const bench::options& options)
+{
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        benchmark_mutex_guarded(options, workload);
+        benchmark_atomic_guarded(options, workload);
+    });
+}
+
+const bool registered = bench::register_suite("atomic", run);
+} // namespace
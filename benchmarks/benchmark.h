@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bench
+{
+/**
+ * @brief Describes a single point in the parameter space that a benchmark is run against.
+ */
+struct workload
+{
+    std::size_t thread_count = 1;
+
+    // The percentage of operations that only need to observe the guarded data.
+    std::size_t read_percentage = 0;
+
+    // The number of arithmetic steps to perform while the lock is held.
+    std::size_t critical_section_length = 0;
+};
+
+/**
+ * @brief The aggregated outcome of running one workload.
+ */
+struct measurement
+{
+    std::uint64_t operations = 0;
+    std::chrono::nanoseconds elapsed{ 0 };
+    std::size_t thread_count = 1;
+
+    auto operations_per_second() const -> double
+    {
+        const auto seconds = std::chrono::duration<double>{ elapsed }.count();
+        return seconds > 0.0 ? static_cast<double>(operations) / seconds : 0.0;
+    }
+
+    /**
+     * @returns The average wall-clock time that a single thread spends on one operation.
+     */
+    auto nanoseconds_per_operation() const -> double
+    {
+        return operations > 0 ? static_cast<double>(elapsed.count()) *
+                                    static_cast<double>(thread_count) /
+                                    static_cast<double>(operations)
+                              : 0.0;
+    }
+};
+
+/**
+ * @brief Settings that control the sweep over the parameter space.
+ */
+struct options
+{
+    std::chrono::milliseconds duration{ 50 };
+    std::vector<std::size_t> thread_counts;
+    std::vector<std::size_t> read_percentages = { 0, 50, 90, 100 };
+    std::vector<std::size_t> critical_section_lengths = { 0, 16, 256 };
+    std::string filter;
+    bool csv = false;
+};
+
+/**
+ * @returns The thread counts from one up to the hardware concurrency, in powers of two, with the
+ * hardware concurrency itself always included.
+ */
+inline auto default_thread_counts() -> std::vector<std::size_t>
+{
+    const std::size_t limit = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::size_t> counts;
+    for (std::size_t count = 1; count < limit; count *= 2) {
+        counts.push_back(count);
+    }
+
+    counts.push_back(limit);
+    return counts;
+}
+
+/**
+ * @brief Simulates work inside of a critical section that mutates the guarded value.
+ */
+inline void write_work(std::uint64_t& value, std::size_t length) noexcept
+{
+    // A linear congruential step can't be folded into a closed form by the optimizer.
+    value = value * 6364136223846793005ull + 1442695040888963407ull;
+    for (std::size_t index = 0; index < length; ++index) {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+    }
+}
+
+/**
+ * @brief Simulates work inside of a critical section that only observes the guarded value.
+ */
+inline auto read_work(const std::uint64_t& value, std::size_t length) noexcept -> std::uint64_t
+{
+    auto result = value;
+    for (std::size_t index = 0; index < length; ++index) {
+        result = result * 6364136223846793005ull + 1442695040888963407ull;
+    }
+
+    return result;
+}
+
+inline volatile std::uint64_t sink = 0;
+
+/**
+ * @brief Prevents the compiler from discarding the computation of an otherwise unused value.
+ */
+inline void do_not_optimize(std::uint64_t value) noexcept
+{
+    sink = value;
+}
+
+/**
+ * @brief A cheap, thread-local pseudo-random number generator (xorshift64).
+ */
+class random_generator
+{
+  public:
+    explicit random_generator(std::uint64_t seed) noexcept : m_state{ seed | 1 }
+    {
+    }
+
+    auto next() noexcept -> std::uint64_t
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state;
+    }
+
+    auto next_percentage() noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(next() % 100);
+    }
+
+  private:
+    std::uint64_t m_state;
+};
+
+/**
+ * @brief Runs the supplied operation on `workload.thread_count` threads for the given duration.
+ *
+ * @param[in] workload            The point in parameter space to measure.
+ * @param[in] duration            How long to let the threads run for.
+ * @param[in] operation           A callable with the signature `void(bool is_read)`, or
+ *                                `void(std::size_t thread_index, bool is_read)`. It is invoked
+ *                                concurrently from every thread, and is expected to perform a
+ *                                single read or write.
+ *
+ * @returns The total number of operations and the elapsed wall-clock time.
+ */
+template <typename OperationType>
+auto run_workload(
+    const workload& workload, std::chrono::milliseconds duration, OperationType&& operation)
+    -> measurement
+{
+    std::atomic<std::size_t> ready_count{ 0 };
+    std::atomic<bool> should_start{ false };
+    std::atomic<bool> should_stop{ false };
+    std::atomic<std::uint64_t> total_operations{ 0 };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workload.thread_count);
+
+    for (std::size_t index = 0; index < workload.thread_count; ++index) {
+        threads.emplace_back([&, index] {
+            random_generator generator{ 0x9E3779B97F4A7C15ull * (index + 1) };
+            std::uint64_t operations = 0;
+
+            ready_count.fetch_add(1);
+            while (!should_start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            while (!should_stop.load(std::memory_order_relaxed)) {
+                const bool is_read = generator.next_percentage() < workload.read_percentage;
+                if constexpr (std::is_invocable_v<OperationType&, std::size_t, bool>) {
+                    operation(index, is_read);
+                } else {
+                    operation(is_read);
+                }
+                ++operations;
+            }
+
+            total_operations.fetch_add(operations);
+        });
+    }
+
+    while (ready_count.load() != workload.thread_count) {
+        std::this_thread::yield();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    should_start.store(true, std::memory_order_release);
+
+    std::this_thread::sleep_for(duration);
+
+    should_stop.store(true);
+    const auto stop = std::chrono::steady_clock::now();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    measurement result;
+    result.operations = total_operations.load();
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+    result.thread_count = workload.thread_count;
+
+    return result;
+}
+
+/**
+ * @brief Prints a single measurement, either as a row in a table or as comma-separated values.
+ */
+inline void report(
+    const options& options, const std::string& suite, const std::string& variant,
+    const workload& workload, const measurement& measurement)
+{
+    const char* const format = options.csv ? "%s,%s,%zu,%zu,%zu,%.0f,%.1f\n"
+                                           : "%-16s %-52s %7zu %6zu%% %6zu %14.0f %10.1f\n";
+
+    std::printf(
+        format, suite.c_str(), variant.c_str(), workload.thread_count, workload.read_percentage,
+        workload.critical_section_length, measurement.operations_per_second(),
+        measurement.nanoseconds_per_operation());
+
+    std::fflush(stdout);
+}
+
+/**
+ * @brief Prints the latency percentiles of one kind of operation, following the measurement of the
+ * same workload. In comma-separated mode, each percentile becomes a row of its own, with the
+ * latency in the `ns_per_op` column.
+ *
+ * @param[in] operation           A label for the kind of operation, e.g., "read".
+ * @param[in] histogram           Any type that provides `percentile(double)`, which returns the
+ *                                given percentile of the recorded latencies as a duration.
+ */
+template <typename HistogramType>
+void report_latency(
+    const options& options, const std::string& suite, const std::string& variant,
+    const workload& workload, const std::string& operation, const HistogramType& histogram)
+{
+    constexpr double percentiles[] = { 50.0, 99.0, 99.9 };
+    constexpr const char* labels[] = { "p50", "p99", "p99.9" };
+
+    if (options.csv) {
+        for (std::size_t index = 0; index < std::size(percentiles); ++index) {
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                histogram.percentile(percentiles[index]));
+
+            std::printf(
+                "%s,%s %s %s,%zu,%zu,%zu,,%lld\n", suite.c_str(), variant.c_str(),
+                operation.c_str(), labels[index], workload.thread_count,
+                workload.read_percentage, workload.critical_section_length,
+                static_cast<long long>(latency.count()));
+        }
+    } else {
+        std::printf("%-16s   %-50s", "", (operation + " latency").c_str());
+        for (std::size_t index = 0; index < std::size(percentiles); ++index) {
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                histogram.percentile(percentiles[index]));
+
+            std::printf(" %s <= %lld ns", labels[index], static_cast<long long>(latency.count()));
+        }
+
+        std::printf("\n");
+    }
+
+    std::fflush(stdout);
+}
+
+/**
+ * @brief Prints the header that precedes the output of `report(...)`.
+ */
+inline void report_header(const options& options)
+{
+    if (options.csv) {
+        std::printf(
+            "suite,variant,threads,read_percentage,critical_section,ops_per_sec,ns_per_op\n");
+        return;
+    }
+
+    std::printf(
+        "%-16s %-52s %7s %7s %6s %14s %10s\n", "suite", "variant", "threads", "reads", "cs",
+        "ops/sec", "ns/op");
+}
+
+/**
+ * @brief Sweeps the workload space described by the options, invoking the supplied function once
+ * per combination of thread count, read percentage, and critical section length.
+ */
+template <typename FunctionType> void for_each_workload(const options& options, FunctionType&& fn)
+{
+    for (const auto critical_section_length : options.critical_section_lengths) {
+        for (const auto read_percentage : options.read_percentages) {
+            for (const auto thread_count : options.thread_counts) {
+                fn(workload{ thread_count, read_percentage, critical_section_length });
+            }
+        }
+    }
+}
+
+using suite_function = std::function<void(const options&)>;
+
+struct suite
+{
+    std::string name;
+    suite_function function;
+};
+
+/**
+ * @returns The list of all registered benchmark suites.
+ */
+inline auto registered_suites() -> std::vector<suite>&
+{
+    static std::vector<suite> suites;
+    return suites;
+}
+
+/**
+ * @brief Registers a benchmark suite so that it can be run from the command line.
+ *
+ * @returns Always true, so that registration can be used to initialize a static variable.
+ */
+inline auto register_suite(std::string name, suite_function function) -> bool
+{
+    registered_suites().push_back({ std::move(name), std::move(function) });
+    return true;
+}
+} // namespace bench
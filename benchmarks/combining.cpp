@@ -0,0 +1,60 @@
+#include "benchmark.h"
+
+#include <combining_guarded.h>
+#include <mutex_guarded.h>
+
+#include <mutex>
+
+/**
+ * @file Compares the throughput of small, heavily contended updates applied through a
+ * `combining_guarded<...>` against those applied through a plain `mutex_guarded<...>`. Flat
+ * combining pays off once enough threads contend for the lock that batches start to form, so the
+ * interesting part of the sweep is at the higher thread counts.
+ */
+
+namespace
+{
+void benchmark_mutex_guarded(const bench::options& options, const bench::workload& workload)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, std::mutex> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        if (is_read) {
+            bench::do_not_optimize(data.with_lock_held(
+                [&](const std::uint64_t& value) { return bench::read_work(value, length); }));
+        } else {
+            data.with_lock_held([&](std::uint64_t& value) { bench::write_work(value, length); });
+        }
+    });
+
+    bench::report(options, "combining", "mutex_guarded<..., std::mutex>", workload, result);
+}
+
+void benchmark_combining_guarded(const bench::options& options, const bench::workload& workload)
+{
+    const auto length = workload.critical_section_length;
+
+    combining_guarded<std::uint64_t, std::mutex> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        if (is_read) {
+            bench::do_not_optimize(data.with_lock_held(
+                [&](const std::uint64_t& value) { return bench::read_work(value, length); }));
+        } else {
+            data.with_lock_held([&](std::uint64_t& value) { bench::write_work(value, length); });
+        }
+    });
+
+    bench::report(options, "combining", "combining_guarded<..., std::mutex>", workload, result);
+}
+
+void run(const bench::options& options)
+{
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        benchmark_mutex_guarded(options, workload);
+        benchmark_combining_guarded(options, workload);
+    });
+}
+
+const bool registered = bench::register_suite("combining", run);
+} // namespace
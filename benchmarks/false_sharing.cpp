@@ -0,0 +1,48 @@
+#include "benchmark.h"
+
+#include <mutex_guarded.h>
+
+/**
+ * @file Measures the effect of the layout policies on an array of per-thread counters, where each
+ * thread only ever touches its own counter. With the `compact_layout`, neighbouring counters share
+ * cache lines, so the threads contend even though no two threads ever lock the same mutex.
+ */
+
+namespace
+{
+template <typename LayoutPolicy>
+void benchmark_layout(const bench::options& options, const std::string& name)
+{
+    using guarded_type = mutex_guarded<std::uint64_t, std::mutex, LayoutPolicy>;
+
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        std::vector<guarded_type> counters(workload.thread_count);
+
+        const auto length = workload.critical_section_length;
+        const auto result = bench::run_workload(
+            workload, options.duration, [&](std::size_t thread_index, bool is_read) {
+                auto& counter = counters[thread_index];
+                if (is_read) {
+                    const auto proxy = counter.lock();
+                    bench::do_not_optimize(bench::read_work(*proxy, length));
+                } else {
+                    auto proxy = counter.lock();
+                    bench::write_work(*proxy, length);
+                }
+            });
+
+        const auto variant = name + " (" + std::to_string(sizeof(guarded_type)) + " bytes)";
+        bench::report(options, "false_sharing", variant, workload, result);
+    });
+}
+
+void run(const bench::options& options)
+{
+    benchmark_layout<compact_layout>(options, "compact_layout");
+    benchmark_layout<padded_layout>(options, "padded_layout");
+    benchmark_layout<split_layout>(options, "split_layout");
+    benchmark_layout<adaptive_layout>(options, "adaptive_layout");
+}
+
+const bool registered = bench::register_suite("false_sharing", run);
+} // namespace
@@ -0,0 +1,337 @@
+#include "benchmark.h"
+
+#include <futex_mutex.h>
+#include <lock_statistics.h>
+#include <mutex_guarded.h>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <shared_mutex>
+
+/**
+ * @file Measures the cost of the locking abstractions offered by `mutex_guarded<...>` relative to
+ * the equivalent hand-written `std::lock_guard`, `std::unique_lock`, and `std::shared_lock` code,
+ * for every mutex category that `detail::mutex_traits<...>` recognizes.
+ */
+
+namespace
+{
+// Long enough that the timed variants never actually time out, so that we measure the overhead of
+// the timed code path itself.
+constexpr auto timeout = std::chrono::seconds{ 1 };
+
+template <typename MutexType> struct raw_state
+{
+    MutexType mutex;
+    std::uint64_t value = 0;
+};
+
+template <typename OperationType>
+void measure(
+    const bench::options& options, const bench::workload& workload, const std::string& variant,
+    OperationType&& operation)
+{
+    const auto result = bench::run_workload(workload, options.duration, operation);
+    bench::report(options, "lock_overhead", variant, workload, result);
+}
+
+/**
+ * @brief Compares `std::lock_guard` against the `lock()` proxy; both are available for every
+ * exclusive mutex category.
+ */
+template <typename MutexType>
+void benchmark_unique_proxy(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    {
+        raw_state<MutexType> state;
+        measure(options, workload, name + " std::lock_guard", [&](bool is_read) {
+            const std::lock_guard<MutexType> guard{ state.mutex };
+            if (is_read) {
+                bench::do_not_optimize(bench::read_work(state.value, length));
+            } else {
+                bench::write_work(state.value, length);
+            }
+        });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(options, workload, name + " lock()", [&](bool is_read) {
+            auto proxy = data.lock();
+            if (is_read) {
+                bench::do_not_optimize(bench::read_work(*proxy, length));
+            } else {
+                bench::write_work(*proxy, length);
+            }
+        });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType, compact_layout, lock_statistics> data{ 0 };
+        measure(options, workload, name + " lock() with lock_statistics", [&](bool is_read) {
+            auto proxy = data.lock();
+            if (is_read) {
+                bench::do_not_optimize(bench::read_work(*proxy, length));
+            } else {
+                bench::write_work(*proxy, length);
+            }
+        });
+    }
+}
+
+template <typename MutexType>
+void benchmark_unique(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    benchmark_unique_proxy<MutexType>(options, workload, name);
+
+    const auto length = workload.critical_section_length;
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(options, workload, name + " with_lock_held", [&](bool is_read) {
+            data.with_lock_held([&](std::uint64_t& value) {
+                if (is_read) {
+                    bench::do_not_optimize(bench::read_work(value, length));
+                } else {
+                    bench::write_work(value, length);
+                }
+            });
+        });
+    }
+}
+
+template <typename MutexType>
+void benchmark_unique_and_timed(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    benchmark_unique_proxy<MutexType>(options, workload, name);
+
+    const auto length = workload.critical_section_length;
+
+    {
+        raw_state<MutexType> state;
+        measure(options, workload, name + " std::unique_lock(timeout)", [&](bool is_read) {
+            const std::unique_lock<MutexType> lock{ state.mutex, timeout };
+            if (!lock.owns_lock()) {
+                return;
+            }
+
+            if (is_read) {
+                bench::do_not_optimize(bench::read_work(state.value, length));
+            } else {
+                bench::write_work(state.value, length);
+            }
+        });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(options, workload, name + " try_lock_for", [&](bool is_read) {
+            auto proxy = data.try_lock_for(timeout);
+            if (!proxy.is_locked()) {
+                return;
+            }
+
+            if (is_read) {
+                bench::do_not_optimize(bench::read_work(*proxy, length));
+            } else {
+                bench::write_work(*proxy, length);
+            }
+        });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(options, workload, name + " try_with_lock_held_for", [&](bool is_read) {
+            const auto result = data.try_with_lock_held_for(timeout, [&](std::uint64_t& value) {
+                if (is_read) {
+                    return bench::read_work(value, length);
+                }
+
+                bench::write_work(value, length);
+                return value;
+            });
+
+            bench::do_not_optimize(result.value_or(0));
+        });
+    }
+}
+
+/**
+ * @brief Compares `std::shared_lock` and `std::lock_guard` against the `read_lock()` and
+ * `write_lock()` proxies; both are available for every shared mutex category.
+ */
+template <typename MutexType>
+void benchmark_shared_proxy(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    {
+        raw_state<MutexType> state;
+        measure(
+            options, workload, name + " std::shared_lock/std::lock_guard", [&](bool is_read) {
+                if (is_read) {
+                    const std::shared_lock<MutexType> lock{ state.mutex };
+                    bench::do_not_optimize(bench::read_work(state.value, length));
+                } else {
+                    const std::lock_guard<MutexType> guard{ state.mutex };
+                    bench::write_work(state.value, length);
+                }
+            });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(options, workload, name + " read_lock()/write_lock()", [&](bool is_read) {
+            if (is_read) {
+                const auto proxy = data.read_lock();
+                bench::do_not_optimize(bench::read_work(*proxy, length));
+            } else {
+                auto proxy = data.write_lock();
+                bench::write_work(*proxy, length);
+            }
+        });
+    }
+}
+
+template <typename MutexType>
+void benchmark_shared(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    benchmark_shared_proxy<MutexType>(options, workload, name);
+
+    const auto length = workload.critical_section_length;
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(
+            options, workload, name + " with_read/write_lock_held", [&](bool is_read) {
+                if (is_read) {
+                    data.with_read_lock_held([&](const std::uint64_t& value) {
+                        bench::do_not_optimize(bench::read_work(value, length));
+                    });
+                } else {
+                    data.with_write_lock_held(
+                        [&](std::uint64_t& value) { bench::write_work(value, length); });
+                }
+            });
+    }
+}
+
+template <typename MutexType>
+void benchmark_shared_and_timed(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    benchmark_shared_proxy<MutexType>(options, workload, name);
+
+    const auto length = workload.critical_section_length;
+
+    {
+        raw_state<MutexType> state;
+        measure(
+            options, workload, name + " std::shared/unique_lock(timeout)", [&](bool is_read) {
+                if (is_read) {
+                    const std::shared_lock<MutexType> lock{ state.mutex, timeout };
+                    if (lock.owns_lock()) {
+                        bench::do_not_optimize(bench::read_work(state.value, length));
+                    }
+                } else {
+                    const std::unique_lock<MutexType> lock{ state.mutex, timeout };
+                    if (lock.owns_lock()) {
+                        bench::write_work(state.value, length);
+                    }
+                }
+            });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(
+            options, workload, name + " try_read/write_lock_for", [&](bool is_read) {
+                if (is_read) {
+                    const auto proxy = data.try_read_lock_for(timeout);
+                    if (proxy.is_locked()) {
+                        bench::do_not_optimize(bench::read_work(*proxy, length));
+                    }
+                } else {
+                    auto proxy = data.try_write_lock_for(timeout);
+                    if (proxy.is_locked()) {
+                        bench::write_work(*proxy, length);
+                    }
+                }
+            });
+    }
+
+    {
+        mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+        measure(
+            options, workload, name + " try_with_read/write_lock_held_for", [&](bool is_read) {
+                if (is_read) {
+                    const auto result = data.try_with_read_lock_held_for(
+                        timeout, [&](const std::uint64_t& value) {
+                            return bench::read_work(value, length);
+                        });
+
+                    bench::do_not_optimize(result.value_or(0));
+                } else {
+                    const auto result =
+                        data.try_with_write_lock_held_for(timeout, [&](std::uint64_t& value) {
+                            bench::write_work(value, length);
+                            return value;
+                        });
+
+                    bench::do_not_optimize(result.value_or(0));
+                }
+            });
+    }
+}
+
+/**
+ * @brief Runs the variants appropriate to the category that `detail::mutex_traits<...>` detects
+ * for the given mutex.
+ */
+template <typename MutexType>
+void benchmark_mutex(const bench::options& options, const std::string& name)
+{
+    using category_type = typename detail::mutex_traits<MutexType>::category_type;
+
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        if constexpr (std::is_same_v<category_type, detail::mutex_category::unique>) {
+            benchmark_unique<MutexType>(options, workload, name);
+        } else if constexpr (std::is_same_v<
+                                 category_type, detail::mutex_category::unique_and_timed>) {
+            benchmark_unique_and_timed<MutexType>(options, workload, name);
+        } else if constexpr (
+            std::is_same_v<category_type, detail::mutex_category::shared> ||
+            std::is_same_v<category_type, detail::mutex_category::upgrade>) {
+            benchmark_shared<MutexType>(options, workload, name);
+        } else if constexpr (std::is_same_v<
+                                 category_type, detail::mutex_category::shared_and_timed>) {
+            benchmark_shared_and_timed<MutexType>(options, workload, name);
+        }
+    });
+}
+
+void run(const bench::options& options)
+{
+    benchmark_mutex<std::mutex>(options, "std::mutex");
+    benchmark_mutex<std::timed_mutex>(options, "std::timed_mutex");
+    benchmark_mutex<std::shared_mutex>(options, "std::shared_mutex");
+    benchmark_mutex<std::shared_timed_mutex>(options, "std::shared_timed_mutex");
+    benchmark_mutex<boost::mutex>(options, "boost::mutex");
+    benchmark_mutex<boost::timed_mutex>(options, "boost::timed_mutex");
+    benchmark_mutex<boost::recursive_mutex>(options, "boost::recursive_mutex");
+    benchmark_mutex<boost::shared_mutex>(options, "boost::shared_mutex");
+    benchmark_mutex<futex_mutex>(options, "futex_mutex");
+    benchmark_mutex<futex_shared_mutex>(options, "futex_shared_mutex");
+}
+
+const bool registered = bench::register_suite("lock_overhead", run);
+} // namespace
@@ -0,0 +1,91 @@
+#include "benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+auto parse_list(const char* text) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> values;
+
+    std::stringstream stream{ text };
+    std::string token;
+
+    while (std::getline(stream, token, ',')) {
+        values.push_back(static_cast<std::size_t>(std::strtoull(token.c_str(), nullptr, 10)));
+    }
+
+    return values;
+}
+
+auto starts_with(const char* text, const char* prefix) -> bool
+{
+    return std::strncmp(text, prefix, std::strlen(prefix)) == 0;
+}
+
+void print_usage()
+{
+    std::printf(
+        "Usage: mutex-guarded-bench [options]\n"
+        "\n"
+        "  --suite=<name>          Only run suites whose name contains <name>.\n"
+        "  --duration=<ms>         Time spent measuring each workload (default: 50).\n"
+        "  --threads=<n,...>       Thread counts (default: 1, 2, 4, ..., hardware concurrency).\n"
+        "  --reads=<pct,...>       Read percentages (default: 0,50,90,100).\n"
+        "  --cs=<steps,...>        Critical section lengths (default: 0,16,256).\n"
+        "  --csv                   Emit comma-separated values instead of a table.\n"
+        "  --list                  List the available suites.\n"
+        "  --help, -h              Show this message.\n");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bench::options options;
+    options.thread_counts = bench::default_thread_counts();
+
+    for (int index = 1; index < argc; ++index) {
+        const char* const argument = argv[index];
+
+        if (starts_with(argument, "--suite=")) {
+            options.filter = argument + std::strlen("--suite=");
+        } else if (starts_with(argument, "--duration=")) {
+            options.duration = std::chrono::milliseconds{ std::strtoll(
+                argument + std::strlen("--duration="), nullptr, 10) };
+        } else if (starts_with(argument, "--threads=")) {
+            options.thread_counts = parse_list(argument + std::strlen("--threads="));
+        } else if (starts_with(argument, "--reads=")) {
+            options.read_percentages = parse_list(argument + std::strlen("--reads="));
+        } else if (starts_with(argument, "--cs=")) {
+            options.critical_section_lengths = parse_list(argument + std::strlen("--cs="));
+        } else if (std::strcmp(argument, "--csv") == 0) {
+            options.csv = true;
+        } else if (std::strcmp(argument, "--list") == 0) {
+            for (const auto& suite : bench::registered_suites()) {
+                std::printf("%s\n", suite.name.c_str());
+            }
+
+            return EXIT_SUCCESS;
+        } else if (std::strcmp(argument, "--help") == 0 || std::strcmp(argument, "-h") == 0) {
+            print_usage();
+            return EXIT_SUCCESS;
+        } else {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    bench::report_header(options);
+
+    for (const auto& suite : bench::registered_suites()) {
+        if (suite.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        suite.function(options);
+    }
+
+    return EXIT_SUCCESS;
+}
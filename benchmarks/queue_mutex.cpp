@@ -0,0 +1,91 @@
+#include "benchmark.h"
+
+#include <cohort_mutex.h>
+#include <futex_mutex.h>
+#include <mutex_guarded.h>
+#include <queue_mutex.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file Compares the fair spin locks against a naive test-and-test-and-set spin lock and the
+ * sleeping mutexes. With enough threads, every waiter of the naive lock contends for the same
+ * cache line on every hand-off, whereas MCS and CLH waiters each spin on their own line. To see
+ * this, run with thread counts well above the default (e.g., `--threads=1,8,32,64`); mind that
+ * all spin locks suffer once there are more threads than cores, since a preempted waiter holds up
+ * the queue behind it. On multi-socket machines, the `cohort_mutex` additionally keeps hand-offs
+ * within a NUMA node.
+ */
+
+namespace
+{
+/**
+ * @brief The baseline: a spin lock on which all waiters spin on the same word.
+ */
+class test_and_set_mutex
+{
+  public:
+    void lock() noexcept
+    {
+        for (std::uint32_t spin = 1; m_is_locked.exchange(true, std::memory_order_acquire);
+             ++spin) {
+            while (m_is_locked.load(std::memory_order_relaxed)) {
+                if (spin++ % 64 == 0) {
+                    std::this_thread::yield();
+                } else {
+                    detail::cpu_relax();
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] auto try_lock() noexcept -> bool
+    {
+        return !m_is_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept
+    {
+        m_is_locked.store(false, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<bool> m_is_locked{ false };
+};
+
+template <typename MutexType>
+void benchmark_mutex(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        auto proxy = data.lock();
+        if (is_read) {
+            bench::do_not_optimize(bench::read_work(*proxy, length));
+        } else {
+            bench::write_work(*proxy, length);
+        }
+    });
+
+    bench::report(options, "queue_mutex", name, workload, result);
+}
+
+void run(const bench::options& options)
+{
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        benchmark_mutex<test_and_set_mutex>(options, workload, "test-and-set spin lock");
+        benchmark_mutex<std::mutex>(options, workload, "std::mutex");
+        benchmark_mutex<futex_mutex>(options, workload, "futex_mutex");
+        benchmark_mutex<ticket_mutex>(options, workload, "ticket_mutex");
+        benchmark_mutex<mcs_mutex>(options, workload, "mcs_mutex");
+        benchmark_mutex<clh_mutex>(options, workload, "clh_mutex");
+        benchmark_mutex<cohort_mutex>(options, workload, "cohort_mutex");
+    });
+}
+
+const bool registered = bench::register_suite("queue_mutex", run);
+} // namespace
@@ -0,0 +1,48 @@
+#include "benchmark.h"
+
+#include <distributed_shared_mutex.h>
+#include <futex_mutex.h>
+#include <mutex_guarded.h>
+
+#include <shared_mutex>
+
+/**
+ * @file Measures how read-mostly workloads scale with the number of threads, for reader-writer
+ * mutexes that keep a single reader count, as opposed to the `distributed_shared_mutex`, which
+ * spreads its readers over per-thread slots. By default, the sweep covers every available core.
+ */
+
+namespace
+{
+template <typename MutexType>
+void benchmark_shared(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+    const auto result = bench::run_workload(workload, options.duration, [&](bool is_read) {
+        if (is_read) {
+            const auto proxy = data.read_lock();
+            bench::do_not_optimize(bench::read_work(*proxy, length));
+        } else {
+            auto proxy = data.write_lock();
+            bench::write_work(*proxy, length);
+        }
+    });
+
+    bench::report(options, "reader_scaling", name, workload, result);
+}
+
+void run(const bench::options& options)
+{
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        benchmark_shared<std::shared_mutex>(options, workload, "std::shared_mutex");
+        benchmark_shared<futex_shared_mutex>(options, workload, "futex_shared_mutex");
+        benchmark_shared<distributed_shared_mutex<>>(
+            options, workload, "distributed_shared_mutex");
+    });
+}
+
+const bool registered = bench::register_suite("reader_scaling", run);
+} // namespace
@@ -0,0 +1,93 @@
+#include "benchmark.h"
+
+#include <lock_statistics.h>
+#include <mutex_guarded.h>
+#include <policy_shared_mutex.h>
+
+#include <chrono>
+#include <shared_mutex>
+#include <vector>
+
+/**
+ * @file Measures how long readers and writers wait for a reader-writer mutex under a mixed load,
+ * for each of the policies of the `policy_shared_mutex`, as well as for the `std::shared_mutex`.
+ * Besides the throughput, every workload reports the percentiles of the time that it took to
+ * acquire a read or a write lock: a reader-preferring mutex shows a long tail of writer latencies
+ * under read-mostly loads, a writer-preferring one the reverse, while a phase-fair one bounds both.
+ * The percentiles are upper bounds, to within a factor of two; see `lock_histogram`.
+ */
+
+namespace
+{
+/**
+ * @brief The latencies recorded by one thread, on a cache line of its own.
+ */
+struct alignas(detail::cache_line_size) thread_latencies
+{
+    lock_histogram read;
+    lock_histogram write;
+};
+
+template <typename MutexType>
+void benchmark_latency(
+    const bench::options& options, const bench::workload& workload, const std::string& name)
+{
+    const auto length = workload.critical_section_length;
+
+    std::vector<thread_latencies> latencies(workload.thread_count);
+
+    mutex_guarded<std::uint64_t, MutexType> data{ 0 };
+    const auto result = bench::run_workload(
+        workload, options.duration, [&](std::size_t thread_index, bool is_read) {
+            auto& histograms = latencies[thread_index];
+            const auto start = std::chrono::steady_clock::now();
+
+            if (is_read) {
+                const auto proxy = data.read_lock();
+                const auto latency = std::chrono::steady_clock::now() - start;
+
+                ++histograms.read.buckets[lock_histogram::bucket_for(latency)];
+                bench::do_not_optimize(bench::read_work(*proxy, length));
+            } else {
+                auto proxy = data.write_lock();
+                const auto latency = std::chrono::steady_clock::now() - start;
+
+                ++histograms.write.buckets[lock_histogram::bucket_for(latency)];
+                bench::write_work(*proxy, length);
+            }
+        });
+
+    thread_latencies total;
+    for (const auto& histograms : latencies) {
+        for (std::size_t bucket = 0; bucket < lock_histogram::bucket_count; ++bucket) {
+            total.read.buckets[bucket] += histograms.read.buckets[bucket];
+            total.write.buckets[bucket] += histograms.write.buckets[bucket];
+        }
+    }
+
+    bench::report(options, "rw_latency", name, workload, result);
+
+    if (total.read.count() > 0) {
+        bench::report_latency(options, "rw_latency", name, workload, "read", total.read);
+    }
+
+    if (total.write.count() > 0) {
+        bench::report_latency(options, "rw_latency", name, workload, "write", total.write);
+    }
+}
+
+void run(const bench::options& options)
+{
+    bench::for_each_workload(options, [&](const bench::workload& workload) {
+        benchmark_latency<std::shared_mutex>(options, workload, "std::shared_mutex");
+        benchmark_latency<policy_shared_mutex<reader_preferring>>(
+            options, workload, "policy_shared_mutex<reader_preferring>");
+        benchmark_latency<policy_shared_mutex<writer_preferring>>(
+            options, workload, "policy_shared_mutex<writer_preferring>");
+        benchmark_latency<policy_shared_mutex<phase_fair>>(
+            options, workload, "policy_shared_mutex<phase_fair>");
+    });
+}
+
+const bool registered = bench::register_suite("rw_latency", run);
+} // namespace
@@ -0,0 +1,470 @@
+#pragma once
+
+#include "mutex_guarded.h"
+#include "parking_lot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace detail
+{
+/**
+ * @brief A spin-then-park strategy that tunes the length of the spin phase to the observed length
+ * of the critical sections.
+ *
+ * Every successful spin feeds the number of iterations that it took into a moving average, while
+ * every spin that runs out of budget halves the estimate. The next spin phase is then allowed to
+ * run for up to twice the estimate (bounded by a hard limit), so that locks with short critical
+ * sections spin just long enough, while locks with long critical sections quickly give up and park.
+ */
+class adaptive_spinner
+{
+  public:
+    static constexpr std::uint32_t max_spin_count = 4096;
+    static constexpr std::uint32_t max_backoff = 64;
+
+    /**
+     * @brief Repeatedly invokes the acquisition function, with exponential backoff in between,
+     * until the spin budget runs out or the optional deadline passes.
+     *
+     * @returns True if the acquisition function succeeded before giving up.
+     */
+    template <typename AcquireType, typename TimePointType = std::nullptr_t>
+    auto spin(AcquireType&& try_acquire, const TimePointType* deadline = nullptr) noexcept -> bool
+    {
+        const auto estimate = m_estimate.load(std::memory_order_relaxed);
+        const auto limit = std::min(max_spin_count, 2 * estimate + 16);
+
+        std::uint32_t spins = 0;
+        std::uint32_t backoff = 1;
+
+        while (spins < limit) {
+            for (std::uint32_t pause = 0; pause < backoff; ++pause) {
+                cpu_relax();
+            }
+
+            spins += backoff;
+
+            if (try_acquire()) {
+                record_success(estimate, spins);
+                return true;
+            }
+
+            if constexpr (!std::is_same_v<TimePointType, std::nullptr_t>) {
+                // Running into the deadline says nothing about the length of the critical
+                // sections, so the estimate is left alone.
+                if (TimePointType::clock::now() >= *deadline) {
+                    return false;
+                }
+            }
+
+            backoff = std::min(backoff * 2, max_backoff);
+        }
+
+        record_failure(estimate);
+        return false;
+    }
+
+    /**
+     * @returns The number of iterations that a spin phase is currently expected to take.
+     */
+    auto estimate() const noexcept -> std::uint32_t
+    {
+        return m_estimate.load(std::memory_order_relaxed);
+    }
+
+  private:
+    void record_success(std::uint32_t estimate, std::uint32_t spins) noexcept
+    {
+        // An exponential moving average with a weight of 1/8; races between threads are benign.
+        const auto delta = (static_cast<std::int64_t>(spins) - estimate) / 8;
+        m_estimate.store(static_cast<std::uint32_t>(estimate + delta), std::memory_order_relaxed);
+    }
+
+    void record_failure(std::uint32_t estimate) noexcept
+    {
+        // The lock is held for longer than we're willing to spin, so spin less next time.
+        m_estimate.store(estimate / 2, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint32_t> m_estimate{ 64 };
+};
+
+/**
+ * @brief The exclusive locking logic shared by `adaptive_mutex` and `adaptive_timed_mutex`.
+ */
+class adaptive_mutex_base
+{
+  public:
+    adaptive_mutex_base() = default;
+
+    adaptive_mutex_base(const adaptive_mutex_base&) = delete;
+    adaptive_mutex_base& operator=(const adaptive_mutex_base&) = delete;
+
+    void lock() noexcept
+    {
+        if (try_lock()) {
+            return;
+        }
+
+        lock_slow<std::nullptr_t>(nullptr);
+    }
+
+    [[nodiscard]] auto try_lock() noexcept -> bool
+    {
+        std::uint32_t expected = unlocked;
+        return m_state.compare_exchange_strong(
+            expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        if (m_state.exchange(unlocked, std::memory_order_release) == locked_with_parked_waiters) {
+            parking_lot::unpark_all(this);
+        }
+    }
+
+  protected:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t locked_with_parked_waiters = 2;
+
+    /**
+     * @brief Spins for a while, and then parks until the lock is acquired or the deadline passes.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename TimePointType> auto lock_slow(const TimePointType* deadline) -> bool
+    {
+        const auto try_acquire = [this] {
+            return m_state.load(std::memory_order_relaxed) == unlocked && try_lock();
+        };
+
+        if (m_spinner.spin(try_acquire, deadline)) {
+            return true;
+        }
+
+        while (true) {
+            // Announce that we're about to park. If the lock happened to be released in the
+            // meantime, then this acquires it instead; in that case the state is conservatively
+            // left at `locked_with_parked_waiters`, which merely costs a superfluous wake-up.
+            if (m_state.exchange(locked_with_parked_waiters, std::memory_order_acquire) ==
+                unlocked) {
+                return true;
+            }
+
+            const auto should_park = [this] {
+                return m_state.load(std::memory_order_relaxed) == locked_with_parked_waiters;
+            };
+
+            if constexpr (std::is_same_v<TimePointType, std::nullptr_t>) {
+                parking_lot::park(this, should_park);
+            } else {
+                if (!parking_lot::park_until(this, should_park, *deadline) &&
+                    TimePointType::clock::now() >= *deadline) {
+                    // One last attempt, so that a timeout never masks an available lock.
+                    return try_acquire();
+                }
+            }
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{ unlocked };
+    adaptive_spinner m_spinner;
+};
+} // namespace detail
+
+/**
+ * @brief A mutex that spins, with exponential backoff, for a bounded and self-tuning number of
+ * iterations before parking the calling thread.
+ *
+ * Most uncontended or briefly contended critical sections are thus handled without ever entering
+ * the kernel, while long waits don't burn CPU time. The mutex occupies eight bytes, since parked
+ * threads are queued in a global `detail::parking_lot`.
+ *
+ * This mutex satisfies the Mutex concept.
+ */
+class adaptive_mutex : private detail::adaptive_mutex_base
+{
+  public:
+    using detail::adaptive_mutex_base::lock;
+    using detail::adaptive_mutex_base::try_lock;
+    using detail::adaptive_mutex_base::unlock;
+};
+
+/**
+ * @brief An `adaptive_mutex` that also supports timed lock acquisition.
+ *
+ * This mutex satisfies the TimedMutex concept.
+ */
+class adaptive_timed_mutex : private detail::adaptive_mutex_base
+{
+  public:
+    using detail::adaptive_mutex_base::lock;
+    using detail::adaptive_mutex_base::try_lock;
+    using detail::adaptive_mutex_base::unlock;
+
+    template <typename RepType, typename PeriodType>
+    [[nodiscard]] auto try_lock_for(const std::chrono::duration<RepType, PeriodType>& timeout)
+        -> bool
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename ClockType, typename DurationType>
+    [[nodiscard]] auto
+    try_lock_until(const std::chrono::time_point<ClockType, DurationType>& deadline) -> bool
+    {
+        if (try_lock()) {
+            return true;
+        }
+
+        return lock_slow(&deadline);
+    }
+};
+
+/**
+ * @brief A reader-writer mutex that spins, with exponential backoff, for a bounded and self-tuning
+ * number of iterations before parking the calling thread.
+ *
+ * Writers that are waiting for the lock prevent new readers from acquiring it, so that a steady
+ * stream of readers can't starve writers.
+ *
+ * This mutex satisfies the SharedTimedMutex concept.
+ */
+class adaptive_shared_timed_mutex
+{
+  public:
+    adaptive_shared_timed_mutex() = default;
+
+    adaptive_shared_timed_mutex(const adaptive_shared_timed_mutex&) = delete;
+    adaptive_shared_timed_mutex& operator=(const adaptive_shared_timed_mutex&) = delete;
+
+    void lock() noexcept
+    {
+        if (!try_lock()) {
+            lock_slow<std::nullptr_t>(write_access, nullptr);
+        }
+    }
+
+    [[nodiscard]] auto try_lock() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        return can_write(state) &&
+               m_state.compare_exchange_strong(
+                   state, state | writer, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        const auto previous =
+            m_state.fetch_and(~(writer | parked_waiters), std::memory_order_release);
+
+        if (previous & parked_waiters) {
+            detail::parking_lot::unpark_all(this);
+        }
+    }
+
+    void lock_shared() noexcept
+    {
+        if (!try_lock_shared()) {
+            lock_slow<std::nullptr_t>(read_access, nullptr);
+        }
+    }
+
+    [[nodiscard]] auto try_lock_shared() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        while (can_read(state)) {
+            if (m_state.compare_exchange_weak(
+                    state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void unlock_shared() noexcept
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        auto next = state;
+
+        do {
+            // The last reader out wakes up any parked threads, and clears the flag in the same
+            // atomic step, so that threads that park afterwards set it anew.
+            next = state - 1;
+            if ((state & reader_mask) == 1) {
+                next &= ~parked_waiters;
+            }
+        } while (!m_state.compare_exchange_weak(
+            state, next, std::memory_order_release, std::memory_order_relaxed));
+
+        if ((state & parked_waiters) && !(next & parked_waiters)) {
+            detail::parking_lot::unpark_all(this);
+        }
+    }
+
+    template <typename RepType, typename PeriodType>
+    [[nodiscard]] auto try_lock_for(const std::chrono::duration<RepType, PeriodType>& timeout)
+        -> bool
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename ClockType, typename DurationType>
+    [[nodiscard]] auto
+    try_lock_until(const std::chrono::time_point<ClockType, DurationType>& deadline) -> bool
+    {
+        return try_lock() || lock_slow(write_access, &deadline);
+    }
+
+    template <typename RepType, typename PeriodType>
+    [[nodiscard]] auto
+    try_lock_shared_for(const std::chrono::duration<RepType, PeriodType>& timeout) -> bool
+    {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename ClockType, typename DurationType>
+    [[nodiscard]] auto
+    try_lock_shared_until(const std::chrono::time_point<ClockType, DurationType>& deadline) -> bool
+    {
+        return try_lock_shared() || lock_slow(read_access, &deadline);
+    }
+
+  private:
+    // The state word packs a writer flag, a flag that indicates that threads are parked, a count
+    // of writers waiting for the lock, and a count of readers holding the lock.
+    static constexpr std::uint32_t writer = 1u << 31;
+    static constexpr std::uint32_t parked_waiters = 1u << 30;
+    static constexpr std::uint32_t pending_writer = 1u << 20;
+    static constexpr std::uint32_t pending_writer_mask = 0x3FFu << 20;
+    static constexpr std::uint32_t reader_mask = pending_writer - 1;
+
+    static constexpr bool read_access = false;
+    static constexpr bool write_access = true;
+
+    static auto can_write(std::uint32_t state) noexcept -> bool
+    {
+        return (state & (writer | reader_mask)) == 0;
+    }
+
+    static auto can_read(std::uint32_t state) noexcept -> bool
+    {
+        return (state & (writer | pending_writer_mask)) == 0;
+    }
+
+    /**
+     * @brief Acquires write access on behalf of a writer that has registered itself as pending.
+     */
+    auto try_lock_as_pending_writer() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        while (can_write(state)) {
+            if (m_state.compare_exchange_weak(
+                    state, (state - pending_writer) | writer, std::memory_order_acquire,
+                    std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Withdraws a pending writer whose deadline has passed.
+     *
+     * @returns True if the lock was acquired after all.
+     */
+    auto abandon_pending_writer() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        auto next = state;
+
+        do {
+            if (can_write(state)) {
+                next = (state - pending_writer) | writer;
+            } else {
+                // Readers might be parked because of this writer, so wake them up.
+                next = (state - pending_writer) & ~parked_waiters;
+            }
+        } while (!m_state.compare_exchange_weak(
+            state, next, std::memory_order_acquire, std::memory_order_relaxed));
+
+        if (next & writer) {
+            return true;
+        }
+
+        if (state & parked_waiters) {
+            detail::parking_lot::unpark_all(this);
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Spins for a while, and then parks until the lock is acquired or the deadline passes.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename TimePointType>
+    auto lock_slow(bool is_writer, const TimePointType* deadline) -> bool
+    {
+        if (is_writer) {
+            // Hold off new readers while we wait.
+            m_state.fetch_add(pending_writer, std::memory_order_relaxed);
+        }
+
+        const auto can_acquire = [is_writer](std::uint32_t state) {
+            return is_writer ? can_write(state) : can_read(state);
+        };
+
+        const auto try_acquire = [&] {
+            return is_writer ? try_lock_as_pending_writer() : try_lock_shared();
+        };
+
+        if (m_spinner.spin(try_acquire, deadline)) {
+            return true;
+        }
+
+        while (true) {
+            auto state = m_state.load(std::memory_order_relaxed);
+            if (can_acquire(state)) {
+                if (try_acquire()) {
+                    return true;
+                }
+
+                continue;
+            }
+
+            // Announce that we're about to park, unless the state changed in the meantime.
+            if (!(state & parked_waiters) &&
+                !m_state.compare_exchange_weak(
+                    state, state | parked_waiters, std::memory_order_relaxed)) {
+                continue;
+            }
+
+            const auto should_park = [&] {
+                const auto current = m_state.load(std::memory_order_relaxed);
+                return (current & parked_waiters) && !can_acquire(current);
+            };
+
+            if constexpr (std::is_same_v<TimePointType, std::nullptr_t>) {
+                detail::parking_lot::park(this, should_park);
+            } else {
+                if (!detail::parking_lot::park_until(this, should_park, *deadline) &&
+                    TimePointType::clock::now() >= *deadline) {
+                    return is_writer ? abandon_pending_writer() : try_lock_shared();
+                }
+            }
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{ 0 };
+    detail::adaptive_spinner m_spinner;
+};
@@ -0,0 +1,382 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#if !defined(__cpp_impl_coroutine)
+#error "async_mutex.h requires C++20 coroutines."
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief The default executor for coroutines that were waiting on an `async_mutex` or an
+ * `async_shared_mutex`: it resumes them right away, on the thread that released the lock.
+ *
+ * Any other executor merely needs to be copyable and to provide
+ * `schedule(std::coroutine_handle<>)`, which must eventually resume the coroutine, e.g. by posting
+ * it to the thread pool or event loop that the coroutine belongs to.
+ */
+struct inline_executor
+{
+    void schedule(std::coroutine_handle<> coroutine) const
+    {
+        coroutine.resume();
+    }
+};
+
+namespace detail
+{
+/**
+ * @brief A node in the queue of an `async_shared_mutex`, representing a coroutine or a thread that
+ * is waiting for the lock. By the time that the waiter is resumed, the lock has been handed to it.
+ */
+class async_waiter
+{
+  public:
+    using function_type = void (*)(async_waiter&) noexcept;
+
+    async_waiter(bool is_shared, function_type function) noexcept
+        : m_is_shared{ is_shared }, m_function{ function }
+    {
+    }
+
+    auto is_shared() const noexcept -> bool
+    {
+        return m_is_shared;
+    }
+
+    /**
+     * @brief Hands the waiter back to its owner, who is free to destroy it right away.
+     */
+    void resume() noexcept
+    {
+        m_function(*this);
+    }
+
+    async_waiter* next = nullptr;
+
+  private:
+    bool m_is_shared;
+    function_type m_function;
+};
+
+/**
+ * @brief A waiter that blocks the calling thread, for the sake of the synchronous locking
+ * functions.
+ *
+ * The grant is signalled under a mutex, rather than through an atomic flag, since the waiter may
+ * be destroyed as soon as the flag has been set, while `notify_one()` would still touch it.
+ */
+class blocking_waiter : public async_waiter
+{
+  public:
+    explicit blocking_waiter(bool is_shared) noexcept : async_waiter{ is_shared, &grant }
+    {
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_condition.wait(lock, [&] { return m_is_granted; });
+    }
+
+  private:
+    static void grant(async_waiter& waiter) noexcept
+    {
+        auto& self = static_cast<blocking_waiter&>(waiter);
+
+        const std::lock_guard<std::mutex> guard{ self.m_mutex };
+        self.m_is_granted = true;
+        self.m_condition.notify_one();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_is_granted = false;
+};
+
+template <typename MutexType, typename ExecutorType> class async_lock_awaiter;
+} // namespace detail
+
+/**
+ * @brief A reader-writer mutex that suspends coroutines, rather than threads, while they wait for
+ * the lock.
+ *
+ * Waiters are queued in FIFO order, and the lock is handed directly to the waiter at the head of
+ * the queue when it is released: either a single writer, or every consecutive reader. New readers
+ * queue up behind a waiting writer, so that writers can't be starved.
+ *
+ * Besides `async_lock()` and `async_lock_shared()`, the mutex also supports the regular
+ * SharedMutex concept, which blocks the calling thread instead, so that a
+ * `mutex_guarded<DataType, async_shared_mutex>` can be used from both coroutines and threads.
+ */
+class async_shared_mutex
+{
+    template <typename M, typename E> friend class detail::async_lock_awaiter;
+
+  public:
+    async_shared_mutex() = default;
+
+    async_shared_mutex(const async_shared_mutex&) = delete;
+    async_shared_mutex& operator=(const async_shared_mutex&) = delete;
+
+    /**
+     * @returns An awaitable that completes once the coroutine holds an exclusive lock. The awaiting
+     * coroutine is resumed through the given executor, unless the lock was free to begin with.
+     */
+    template <typename ExecutorType = inline_executor>
+    auto async_lock(ExecutorType executor = {})
+        -> detail::async_lock_awaiter<async_shared_mutex, ExecutorType>
+    {
+        return { *this, false, std::move(executor) };
+    }
+
+    /**
+     * @returns An awaitable that completes once the coroutine holds a shared lock. The awaiting
+     * coroutine is resumed through the given executor, unless the lock was free to begin with.
+     */
+    template <typename ExecutorType = inline_executor>
+    auto async_lock_shared(ExecutorType executor = {})
+        -> detail::async_lock_awaiter<async_shared_mutex, ExecutorType>
+    {
+        return { *this, true, std::move(executor) };
+    }
+
+    void lock()
+    {
+        detail::blocking_waiter waiter{ false };
+        if (!acquire_or_enqueue(waiter)) {
+            waiter.wait();
+        }
+    }
+
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        const std::lock_guard<std::mutex> guard{ m_state_mutex };
+        return try_acquire(false);
+    }
+
+    void unlock()
+    {
+        release(false);
+    }
+
+    void lock_shared()
+    {
+        detail::blocking_waiter waiter{ true };
+        if (!acquire_or_enqueue(waiter)) {
+            waiter.wait();
+        }
+    }
+
+    [[nodiscard]] auto try_lock_shared() -> bool
+    {
+        const std::lock_guard<std::mutex> guard{ m_state_mutex };
+        return try_acquire(true);
+    }
+
+    void unlock_shared()
+    {
+        release(true);
+    }
+
+  private:
+    // The value of `m_holders` while a writer holds the lock.
+    static constexpr std::ptrdiff_t exclusively_held = -1;
+
+    /**
+     * @brief Acquires the lock if it is available and no one else is waiting for it. The state
+     * mutex must be held.
+     */
+    auto try_acquire(bool is_shared) noexcept -> bool
+    {
+        if (m_head) {
+            return false;
+        }
+
+        if (is_shared) {
+            if (m_holders == exclusively_held) {
+                return false;
+            }
+
+            ++m_holders;
+            return true;
+        }
+
+        if (m_holders != 0) {
+            return false;
+        }
+
+        m_holders = exclusively_held;
+        return true;
+    }
+
+    /**
+     * @brief Acquires the lock if possible, and enqueues the waiter otherwise.
+     *
+     * @returns True if the lock was acquired; the waiter won't be resumed in that case.
+     */
+    auto acquire_or_enqueue(detail::async_waiter& waiter) -> bool
+    {
+        const std::lock_guard<std::mutex> guard{ m_state_mutex };
+        if (try_acquire(waiter.is_shared())) {
+            return true;
+        }
+
+        waiter.next = nullptr;
+        if (m_tail) {
+            m_tail->next = &waiter;
+        } else {
+            m_head = &waiter;
+        }
+
+        m_tail = &waiter;
+        return false;
+    }
+
+    /**
+     * @brief Releases the lock, hands it to the waiters at the head of the queue, if possible, and
+     * then resumes those waiters outside of the state mutex.
+     */
+    void release(bool is_shared)
+    {
+        detail::async_waiter* granted = nullptr;
+
+        {
+            const std::lock_guard<std::mutex> guard{ m_state_mutex };
+
+            m_holders = is_shared ? m_holders - 1 : 0;
+            if (m_holders == 0 && m_head) {
+                granted = grant_to_head();
+            }
+        }
+
+        while (granted) {
+            // The waiter may be destroyed as soon as it has been resumed.
+            auto* const next = granted->next;
+            granted->resume();
+            granted = next;
+        }
+    }
+
+    /**
+     * @brief Dequeues either the writer at the head of the queue, or all consecutive readers, and
+     * hands them the lock. The state mutex must be held, and the lock must be free.
+     *
+     * @returns The dequeued waiters, as a null-terminated list.
+     */
+    auto grant_to_head() noexcept -> detail::async_waiter*
+    {
+        auto* const first = m_head;
+        auto* last = first;
+
+        if (first->is_shared()) {
+            m_holders = 1;
+            while (last->next && last->next->is_shared()) {
+                last = last->next;
+                ++m_holders;
+            }
+        } else {
+            m_holders = exclusively_held;
+        }
+
+        m_head = last->next;
+        if (!m_head) {
+            m_tail = nullptr;
+        }
+
+        last->next = nullptr;
+        return first;
+    }
+
+    std::mutex m_state_mutex;
+
+    std::ptrdiff_t m_holders = 0;
+
+    detail::async_waiter* m_head = nullptr;
+    detail::async_waiter* m_tail = nullptr;
+};
+
+/**
+ * @brief An exclusive-only `async_shared_mutex`, for use as the mutex of a `mutex_guarded<...>`
+ * that only ever needs exclusive locks. It supports the regular Mutex concept as well.
+ */
+class async_mutex
+{
+  public:
+    template <typename ExecutorType = inline_executor>
+    auto async_lock(ExecutorType executor = {})
+    {
+        return m_mutex.async_lock(std::move(executor));
+    }
+
+    void lock()
+    {
+        m_mutex.lock();
+    }
+
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        return m_mutex.try_lock();
+    }
+
+    void unlock()
+    {
+        m_mutex.unlock();
+    }
+
+  private:
+    async_shared_mutex m_mutex;
+};
+
+namespace detail
+{
+/**
+ * @brief The awaitable returned by `async_shared_mutex::async_lock(...)` and
+ * `async_shared_mutex::async_lock_shared(...)`. It has to be awaited right away, since it is
+ * linked into the mutex's queue while the coroutine is suspended.
+ */
+template <typename MutexType, typename ExecutorType>
+class async_lock_awaiter : private async_waiter
+{
+  public:
+    async_lock_awaiter(MutexType& mutex, bool is_shared, ExecutorType executor)
+        : async_waiter{ is_shared, &schedule }, m_mutex{ mutex }, m_executor{ std::move(executor) }
+    {
+    }
+
+    auto await_ready() -> bool
+    {
+        return is_shared() ? m_mutex.try_lock_shared() : m_mutex.try_lock();
+    }
+
+    /**
+     * @returns False if the lock was acquired in the meantime, in which case the coroutine
+     * continues right away.
+     */
+    auto await_suspend(std::coroutine_handle<> coroutine) -> bool
+    {
+        m_coroutine = coroutine;
+        return !m_mutex.acquire_or_enqueue(*this);
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+  private:
+    static void schedule(async_waiter& waiter) noexcept
+    {
+        auto& self = static_cast<async_lock_awaiter&>(waiter);
+        self.m_executor.schedule(self.m_coroutine);
+    }
+
+    MutexType& m_mutex;
+    ExecutorType m_executor;
+    std::coroutine_handle<> m_coroutine;
+};
+} // namespace detail
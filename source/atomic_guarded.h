@@ -0,0 +1,373 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace detail
+{
+/**
+ * @brief Stores the data in a `std::atomic<...>`, which is lock-free for all data that fits into
+ * a machine word.
+ */
+template <typename DataType, typename = void> class atomic_storage
+{
+  public:
+    static constexpr bool is_always_lock_free = std::atomic<DataType>::is_always_lock_free;
+
+    explicit atomic_storage(const DataType& data) noexcept : m_data{ data }
+    {
+    }
+
+    auto load() const noexcept -> DataType
+    {
+        return m_data.load(std::memory_order_acquire);
+    }
+
+    void store(const DataType& data) noexcept
+    {
+        m_data.store(data, std::memory_order_release);
+    }
+
+    auto exchange(const DataType& data) noexcept -> DataType
+    {
+        return m_data.exchange(data, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Replaces the data if it still equals the expected value; otherwise, updates the
+     * expected value to the current one.
+     */
+    auto compare_exchange(DataType& expected, const DataType& desired) noexcept -> bool
+    {
+        return m_data.compare_exchange_weak(
+            expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+  private:
+    std::atomic<DataType> m_data;
+};
+
+#if (defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && defined(__SIZEOF_INT128__)) ||               \
+    (defined(_MSC_VER) && defined(_M_X64))
+#define MUTEX_GUARDED_HAS_DOUBLE_WORD_CAS 1
+#else
+#define MUTEX_GUARDED_HAS_DOUBLE_WORD_CAS 0
+#endif
+
+#if MUTEX_GUARDED_HAS_DOUBLE_WORD_CAS
+/**
+ * @brief Stores 16-byte data that the standard library won't treat as lock-free (GCC and Clang
+ * route such atomics through libatomic) using the platform's double-word compare-and-swap
+ * directly. On x86-64, this requires compiling with `-mcx16` on GCC and Clang.
+ *
+ * Since there is no 16-byte atomic load, loads are performed as a compare-and-swap that replaces
+ * the data with itself, which means that they do write to the cache line.
+ */
+template <typename DataType>
+class atomic_storage<
+    DataType,
+    std::enable_if_t<sizeof(DataType) == 16 && !std::atomic<DataType>::is_always_lock_free>>
+{
+  public:
+    static constexpr bool is_always_lock_free = true;
+
+    explicit atomic_storage(const DataType& data) noexcept
+    {
+        std::memcpy(&m_words, &data, sizeof(DataType));
+    }
+
+    auto load() const noexcept -> DataType
+    {
+        words_type expected{};
+        compare_exchange_words(expected, expected);
+
+        return from_words(expected);
+    }
+
+    void store(const DataType& data) noexcept
+    {
+        exchange(data);
+    }
+
+    auto exchange(const DataType& data) noexcept -> DataType
+    {
+        auto expected = to_words(load());
+        while (!compare_exchange_words(expected, to_words(data))) {
+        }
+
+        return from_words(expected);
+    }
+
+    auto compare_exchange(DataType& expected, const DataType& desired) noexcept -> bool
+    {
+        auto expected_words = to_words(expected);
+        if (compare_exchange_words(expected_words, to_words(desired))) {
+            return true;
+        }
+
+        expected = from_words(expected_words);
+        return false;
+    }
+
+  private:
+#if defined(_MSC_VER)
+    struct words_type
+    {
+        std::int64_t low;
+        std::int64_t high;
+    };
+#else
+    __extension__ using words_type = unsigned __int128;
+#endif
+
+    static auto to_words(const DataType& data) noexcept -> words_type
+    {
+        words_type words;
+        std::memcpy(&words, &data, sizeof(DataType));
+        return words;
+    }
+
+    static auto from_words(const words_type& words) noexcept -> DataType
+    {
+        DataType data;
+        std::memcpy(static_cast<void*>(&data), &words, sizeof(DataType));
+        return data;
+    }
+
+    auto compare_exchange_words(words_type& expected, const words_type& desired) const noexcept
+        -> bool
+    {
+#if defined(_MSC_VER)
+        return _InterlockedCompareExchange128(
+            &m_words.low, desired.high, desired.low, &expected.low);
+#else
+        const auto previous = __sync_val_compare_and_swap(&m_words, expected, desired);
+        const auto was_exchanged = previous == expected;
+
+        expected = previous;
+        return was_exchanged;
+#endif
+    }
+
+    alignas(16) mutable words_type m_words;
+};
+#endif
+
+template <typename DataType>
+struct has_lock_free_storage
+    : std::bool_constant<atomic_storage<DataType>::is_always_lock_free>
+{
+};
+} // namespace detail
+
+/**
+ * @brief Indicates whether an `atomic_guarded<DataType>` can guard the given type without falling
+ * back on a lock, including by way of a 16-byte compare-and-swap where the platform provides one.
+ */
+template <typename DataType>
+constexpr bool is_atomic_guardable_v = std::conjunction_v<
+    std::is_trivially_copyable<DataType>, std::is_default_constructible<DataType>,
+    detail::has_lock_free_storage<DataType>>;
+
+/**
+ * @brief A wrapper around small, trivially copyable data that is guarded without a mutex, by
+ * storing it in a lock-free atomic.
+ *
+ * Reading functors are invoked on a snapshot of the data. Modifying functors are invoked on a
+ * local copy of the data, which is then published with a compare-and-swap; if another thread
+ * modified the data in the meantime, the functor is invoked again on a fresh copy. As such,
+ * modifying functors may run more than once, and should not have side effects beyond the data
+ * that they are passed.
+ *
+ * The data is compared bitwise, so types with padding bits should be avoided, since a padding
+ * mismatch causes spurious retries.
+ *
+ * `with_lock_held(...)` mirrors that of a `mutex_guarded<DataType>`, so that switching between
+ * the two only requires a change of type, as long as the functors are safe to retry and return
+ * their results by value. See also `maybe_atomic_guarded<...>`.
+ */
+template <typename DataType> class atomic_guarded
+{
+    static_assert(
+        std::is_trivially_copyable_v<DataType>,
+        "An atomic_guarded<...> can only guard trivially copyable data.");
+
+    static_assert(
+        std::is_default_constructible_v<DataType>,
+        "An atomic_guarded<...> needs to be able to default construct a local copy of the data.");
+
+    static_assert(
+        detail::atomic_storage<DataType>::is_always_lock_free,
+        "An atomic_guarded<...> can only guard data that the platform can update atomically "
+        "without a lock; consider maybe_atomic_guarded<...> instead.");
+
+  public:
+    using value_type = DataType;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    atomic_guarded() : atomic_guarded{ DataType{} }
+    {
+    }
+
+    atomic_guarded(const DataType& data) : m_storage{ data }
+    {
+    }
+
+    atomic_guarded(const atomic_guarded&) = delete;
+    atomic_guarded& operator=(const atomic_guarded&) = delete;
+
+    /**
+     * @brief Executes the passed in functor on the data.
+     *
+     * The functor is invoked on a local copy, which is then published with a compare-and-swap,
+     * retrying on a fresh copy until the swap succeeds. If the functor leaves its copy unchanged,
+     * as a reader does, nothing is published, and the functor is only invoked once. Generic
+     * functors are therefore always passed a mutable reference, just as by a `mutex_guarded<...>`.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value. It may be
+     *                                invoked more than once.
+     *
+     * @returns The result of the final invocation of the functor.
+     */
+    template <typename CallableType> auto with_lock_held(CallableType&& callable)
+    {
+        return with_write_lock_held(callable);
+    }
+
+    /**
+     * @brief Executes the passed in functor on a snapshot of the data.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> auto with_lock_held(CallableType&& callable) const
+    {
+        return with_read_lock_held(callable);
+    }
+
+    /**
+     * @brief Executes the passed in functor on a snapshot of the data.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> auto with_read_lock_held(CallableType&& callable) const
+    {
+        static_assert(
+            !std::is_reference_v<decltype(callable(std::declval<const DataType&>()))>,
+            "The functor operates on a local copy of the data, so it can't return a reference.");
+
+        const DataType snapshot = m_storage.load();
+        return callable(snapshot);
+    }
+
+    /**
+     * @brief Executes the passed in functor on a local copy of the data, and then publishes the
+     * modified copy, retrying until no other thread has modified the data in the meantime.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value. It may be
+     *                                invoked more than once.
+     *
+     * @returns The result of the final invocation of the functor.
+     */
+    template <typename CallableType> auto with_write_lock_held(CallableType&& callable)
+    {
+        using result_type = decltype(callable(std::declval<DataType&>()));
+
+        static_assert(
+            !std::is_reference_v<result_type>,
+            "The functor operates on a local copy of the data, so it can't return a reference.");
+
+        auto expected = m_storage.load();
+        while (true) {
+            auto desired = expected;
+
+            if constexpr (std::is_void_v<result_type>) {
+                callable(desired);
+
+                if (publish(expected, desired)) {
+                    return;
+                }
+            } else {
+                auto result = callable(desired);
+
+                if (publish(expected, desired)) {
+                    return result;
+                }
+            }
+        }
+    }
+
+    /**
+     * @returns A snapshot of the data.
+     */
+    auto read() const -> DataType
+    {
+        return m_storage.load();
+    }
+
+    /**
+     * @brief Replaces the data.
+     */
+    void write(const DataType& data)
+    {
+        m_storage.store(data);
+    }
+
+    /**
+     * @brief Replaces the data.
+     *
+     * @returns The data that was replaced.
+     */
+    auto exchange(const DataType& data) -> DataType
+    {
+        return m_storage.exchange(data);
+    }
+
+  private:
+    /**
+     * @brief Publishes the modified copy, unless it is bitwise identical to the expected value.
+     *
+     * @returns False if another thread modified the data in the meantime, in which case the
+     * expected value is updated to the current one.
+     */
+    auto publish(DataType& expected, const DataType& desired) -> bool
+    {
+        if (std::memcmp(&expected, &desired, sizeof(DataType)) == 0) {
+            return true;
+        }
+
+        return m_storage.compare_exchange(expected, desired);
+    }
+
+    detail::atomic_storage<DataType> m_storage;
+};
+
+/**
+ * @brief Selects an `atomic_guarded<DataType>` if the data can be guarded without a lock, and a
+ * `mutex_guarded<DataType, MutexType>` otherwise. The common ground between the two is
+ * `with_lock_held(...)` with functors that are safe to retry and return their results by value.
+ */
+template <typename DataType, typename MutexType = std::mutex>
+using maybe_atomic_guarded = std::conditional_t<
+    is_atomic_guardable_v<DataType>, atomic_guarded<DataType>, mutex_guarded<DataType, MutexType>>;
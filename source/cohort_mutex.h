@@ -0,0 +1,415 @@
+#pragma once
+
+#include "mutex_guarded.h"
+#include "queue_mutex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace detail
+{
+/**
+ * @brief Parses a list of CPU or node indices in the kernel's list format, e.g., "0-3,8,10-11".
+ *
+ * @returns The indices in the list, or an empty list if the text is malformed.
+ */
+inline auto parse_index_list(const std::string& text) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> indices;
+
+    std::size_t position = 0;
+    while (position < text.size() && text[position] != '\n') {
+        std::size_t first = 0;
+        std::size_t length = 0;
+
+        try {
+            first = std::stoul(text.substr(position), &length);
+        } catch (...) {
+            return {};
+        }
+
+        position += length;
+        auto last = first;
+
+        if (position < text.size() && text[position] == '-') {
+            try {
+                last = std::stoul(text.substr(position + 1), &length);
+            } catch (...) {
+                return {};
+            }
+
+            position += length + 1;
+        }
+
+        for (auto index = first; index <= last; ++index) {
+            indices.push_back(index);
+        }
+
+        if (position < text.size() && text[position] == ',') {
+            ++position;
+        }
+    }
+
+    return indices;
+}
+
+/**
+ * @returns The first line of the file, or an empty string if it can't be read.
+ */
+inline auto read_first_line(const std::string& path) -> std::string
+{
+    std::ifstream file{ path };
+
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+/**
+ * @brief The NUMA node that the calling thread pretends to run on, if any. See `scoped_numa_node`.
+ */
+inline auto numa_node_override() noexcept -> std::ptrdiff_t&
+{
+    thread_local std::ptrdiff_t node = -1;
+    return node;
+}
+} // namespace detail
+
+/**
+ * @brief Describes which CPUs belong to which NUMA node. Nodes are numbered densely from zero, in
+ * the order in which the system lists them.
+ */
+class numa_topology
+{
+  public:
+    /**
+     * @brief A topology that consists of a single node, to which every CPU belongs.
+     */
+    numa_topology() = default;
+
+    /**
+     * @brief A topology that maps CPU `i` onto the `i`-th entry of the list.
+     */
+    explicit numa_topology(std::vector<std::size_t> node_of_cpu)
+        : m_node_of_cpu{ std::move(node_of_cpu) }
+    {
+        for (const auto node : m_node_of_cpu) {
+            m_node_count = std::max(m_node_count, node + 1);
+        }
+    }
+
+    /**
+     * @brief Reads the topology from sysfs, or from a directory with the same layout: an `online`
+     * file that lists the nodes, and a `node<N>/cpulist` file for each node.
+     *
+     * @returns The topology, or a single-node topology if the directory can't be read.
+     */
+    static auto from_sysfs(const std::string& root = "/sys/devices/system/node") -> numa_topology
+    {
+        const auto nodes = detail::parse_index_list(detail::read_first_line(root + "/online"));
+
+        std::vector<std::size_t> node_of_cpu;
+        for (std::size_t node = 0; node < nodes.size(); ++node) {
+            const auto path = root + "/node" + std::to_string(nodes[node]) + "/cpulist";
+
+            for (const auto cpu : detail::parse_index_list(detail::read_first_line(path))) {
+                if (cpu >= node_of_cpu.size()) {
+                    node_of_cpu.resize(cpu + 1, 0);
+                }
+
+                node_of_cpu[cpu] = node;
+            }
+        }
+
+        return numa_topology{ std::move(node_of_cpu) };
+    }
+
+    /**
+     * @returns The topology that newly constructed cohort mutexes use: the one read from sysfs, or
+     * the one passed to `use_for_new_mutexes(...)`, if any.
+     */
+    static auto current() -> std::shared_ptr<const numa_topology>
+    {
+        const std::lock_guard<std::mutex> guard{ state().mutex };
+        if (!state().topology) {
+            state().topology = std::make_shared<const numa_topology>(from_sysfs());
+        }
+
+        return state().topology;
+    }
+
+    /**
+     * @brief Overrides the topology that newly constructed cohort mutexes use, e.g., to simulate a
+     * multi-node system in tests. Existing mutexes keep the topology that they were built with.
+     */
+    static void use_for_new_mutexes(numa_topology topology)
+    {
+        const std::lock_guard<std::mutex> guard{ state().mutex };
+        state().topology = std::make_shared<const numa_topology>(std::move(topology));
+    }
+
+    auto node_count() const noexcept -> std::size_t
+    {
+        return m_node_count;
+    }
+
+    /**
+     * @returns The node that the CPU belongs to, or node zero for CPUs that the topology doesn't
+     * know about.
+     */
+    auto node_of_cpu(std::size_t cpu) const noexcept -> std::size_t
+    {
+        return cpu < m_node_of_cpu.size() ? m_node_of_cpu[cpu] : 0;
+    }
+
+    /**
+     * @returns The node that the calling thread is currently running on, unless the thread has
+     * been pinned to a node by a `scoped_numa_node`.
+     */
+    auto current_node() const noexcept -> std::size_t
+    {
+        const auto pinned = detail::numa_node_override();
+        if (pinned >= 0) {
+            return static_cast<std::size_t>(pinned) % m_node_count;
+        }
+
+#if defined(__linux__)
+        const auto cpu = sched_getcpu();
+        return cpu >= 0 ? node_of_cpu(static_cast<std::size_t>(cpu)) : 0;
+#else
+        return 0;
+#endif
+    }
+
+  private:
+    struct global_state
+    {
+        std::mutex mutex;
+        std::shared_ptr<const numa_topology> topology;
+    };
+
+    static auto state() -> global_state&
+    {
+        static global_state instance;
+        return instance;
+    }
+
+    std::vector<std::size_t> m_node_of_cpu;
+    std::size_t m_node_count = 1;
+};
+
+/**
+ * @brief Makes the calling thread pretend that it runs on the given NUMA node for as long as this
+ * object lives, which allows cohort locking to be tested on a single-node system.
+ */
+class scoped_numa_node
+{
+  public:
+    explicit scoped_numa_node(std::size_t node) noexcept
+        : m_previous{ std::exchange(
+              detail::numa_node_override(), static_cast<std::ptrdiff_t>(node)) }
+    {
+    }
+
+    ~scoped_numa_node() noexcept
+    {
+        detail::numa_node_override() = m_previous;
+    }
+
+    scoped_numa_node(const scoped_numa_node&) = delete;
+    scoped_numa_node& operator=(const scoped_numa_node&) = delete;
+
+  private:
+    std::ptrdiff_t m_previous;
+};
+
+namespace detail
+{
+/**
+ * @brief The local lock of one NUMA node: a ticket lock, since it can tell whether other threads
+ * are waiting, plus the state that the cohort shares. Only the holder of the local lock accesses
+ * the non-atomic members.
+ */
+struct alignas(cache_line_size) cohort_node
+{
+    std::atomic<std::uint32_t> next_ticket{ 0 };
+    std::atomic<std::uint32_t> now_serving{ 0 };
+
+    bool owns_global_lock = false;
+    std::uint32_t local_handoffs = 0;
+};
+
+struct cohort_inspector;
+} // namespace detail
+
+/**
+ * @brief A NUMA-aware cohort lock: a global lock, plus a local lock per NUMA node.
+ *
+ * A thread first acquires the local lock of the node that it runs on, and then the global lock,
+ * unless a thread on the same node passed the global lock on to it. When releasing the lock while
+ * other threads on the same node are waiting, the global lock is passed on to the next local
+ * waiter, so that the data and the lock's cache lines stay within the node. To keep other nodes
+ * from starving, the global lock is released after `LocalHandoffLimit` consecutive local hand-offs.
+ *
+ * Both the local and the global locks are ticket locks, so waiters spin, and locks are granted in
+ * FIFO order within each level. The node topology is read from sysfs when the mutex is
+ * constructed; see `numa_topology::use_for_new_mutexes(...)` and `scoped_numa_node` to simulate
+ * other topologies.
+ *
+ * This mutex satisfies the Mutex concept.
+ */
+template <std::uint32_t LocalHandoffLimit = 64> class basic_cohort_mutex
+{
+    static_assert(LocalHandoffLimit > 0, "A cohort lock has to allow for at least one hand-off.");
+
+    friend struct detail::cohort_inspector;
+
+  public:
+    basic_cohort_mutex()
+        : m_topology{ numa_topology::current() },
+          m_nodes{ std::make_unique<detail::cohort_node[]>(m_topology->node_count()) }
+    {
+    }
+
+    basic_cohort_mutex(const basic_cohort_mutex&) = delete;
+    basic_cohort_mutex& operator=(const basic_cohort_mutex&) = delete;
+
+    void lock()
+    {
+        auto& node = local_node();
+        const auto ticket = node.next_ticket.fetch_add(1, std::memory_order_relaxed);
+
+        for (std::uint32_t attempt = 1;
+             node.now_serving.load(std::memory_order_acquire) != ticket; ++attempt) {
+            if (attempt % 64 == 0) {
+                std::this_thread::yield();
+            } else {
+                detail::cpu_relax();
+            }
+        }
+
+        if (!node.owns_global_lock) {
+            m_global.lock();
+            node.owns_global_lock = true;
+        }
+
+        m_holder = &node;
+    }
+
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        auto& node = local_node();
+
+        auto ticket = node.now_serving.load(std::memory_order_relaxed);
+        if (!node.next_ticket.compare_exchange_strong(
+                ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return false;
+        }
+
+        if (!node.owns_global_lock) {
+            if (!m_global.try_lock()) {
+                release_local(node);
+                return false;
+            }
+
+            node.owns_global_lock = true;
+        }
+
+        m_holder = &node;
+        return true;
+    }
+
+    void unlock() noexcept
+    {
+        auto& node = *m_holder;
+
+        const auto serving = node.now_serving.load(std::memory_order_relaxed);
+        const auto has_local_waiters =
+            node.next_ticket.load(std::memory_order_relaxed) - serving > 1;
+
+        if (has_local_waiters && node.local_handoffs < LocalHandoffLimit) {
+            // Keep the global lock within the cohort, and pass it on with the local lock.
+            ++node.local_handoffs;
+        } else {
+            node.local_handoffs = 0;
+            node.owns_global_lock = false;
+            m_global.unlock();
+        }
+
+        release_local(node);
+    }
+
+    /**
+     * @returns The number of nodes that this mutex keeps a local lock for.
+     */
+    auto node_count() const noexcept -> std::size_t
+    {
+        return m_topology->node_count();
+    }
+
+  private:
+    auto local_node() const noexcept -> detail::cohort_node&
+    {
+        return m_nodes[m_topology->current_node() % m_topology->node_count()];
+    }
+
+    static void release_local(detail::cohort_node& node) noexcept
+    {
+        const auto serving = node.now_serving.load(std::memory_order_relaxed);
+        node.now_serving.store(serving + 1, std::memory_order_release);
+    }
+
+    std::shared_ptr<const numa_topology> m_topology;
+    std::unique_ptr<detail::cohort_node[]> m_nodes;
+
+    // A ticket lock can be released by a different thread than the one that acquired it, which
+    // the global lock requires, since it's passed around within a cohort.
+    ticket_mutex m_global;
+
+    // Only ever accessed by the lock holder.
+    detail::cohort_node* m_holder = nullptr;
+};
+
+using cohort_mutex = basic_cohort_mutex<>;
+
+namespace detail
+{
+/**
+ * @brief Observes the queues of a cohort lock without taking part in them, so that tests can wait
+ * for a thread to have queued up, rather than relying on timing.
+ */
+struct cohort_inspector
+{
+    /**
+     * @returns The number of tickets that have been handed out for the local lock of the node.
+     */
+    template <std::uint32_t LocalHandoffLimit>
+    static auto local_tickets(const basic_cohort_mutex<LocalHandoffLimit>& mutex, std::size_t node)
+        -> std::uint32_t
+    {
+        return mutex.m_nodes[node].next_ticket.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @returns A value that changes whenever a cohort joins the queue for the global lock.
+     */
+    template <std::uint32_t LocalHandoffLimit>
+    static auto global_tail(const basic_cohort_mutex<LocalHandoffLimit>& mutex) -> std::uintptr_t
+    {
+        return queue_inspector::tail(mutex.m_global);
+    }
+};
+} // namespace detail
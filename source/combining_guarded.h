@@ -0,0 +1,269 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace detail
+{
+/**
+ * @brief An operation that a thread has published, so that whichever thread holds the lock can
+ * execute it on the publisher's behalf.
+ */
+template <typename DataType> class combining_operation
+{
+  public:
+    using function_type = void (*)(combining_operation&, DataType&);
+
+    explicit combining_operation(function_type function) noexcept : m_function{ function }
+    {
+    }
+
+    combining_operation(const combining_operation&) = delete;
+    combining_operation& operator=(const combining_operation&) = delete;
+
+    /**
+     * @brief Executes the operation, and then hands it back to its publisher. The operation must
+     * not be touched afterwards, since the publisher is free to destroy it.
+     */
+    void execute(DataType& data) noexcept
+    {
+        try {
+            m_function(*this, data);
+        } catch (...) {
+            m_exception = std::current_exception();
+        }
+
+        m_is_done.store(true, std::memory_order_release);
+    }
+
+    auto is_done() const noexcept -> bool
+    {
+        return m_is_done.load(std::memory_order_acquire);
+    }
+
+    void rethrow_if_failed() const
+    {
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+  private:
+    function_type m_function;
+    std::exception_ptr m_exception;
+    std::atomic<bool> m_is_done{ false };
+};
+
+/**
+ * @brief An operation that invokes a callable on the data, and holds on to its result until the
+ * publisher collects it.
+ */
+template <typename DataType, typename CallableType>
+class combining_task : public combining_operation<DataType>
+{
+  public:
+    using result_type = decltype(std::declval<CallableType&>()(std::declval<DataType&>()));
+
+    explicit combining_task(CallableType& callable) noexcept
+        : combining_operation<DataType>{ &invoke }, m_callable{ callable }
+    {
+    }
+
+    auto take_result() -> result_type
+    {
+        if constexpr (!std::is_void_v<result_type>) {
+            return std::move(*m_result);
+        }
+    }
+
+  private:
+    static void invoke(combining_operation<DataType>& operation, DataType& data)
+    {
+        auto& task = static_cast<combining_task&>(operation);
+
+        if constexpr (std::is_void_v<result_type>) {
+            task.m_callable(data);
+        } else {
+            task.m_result.emplace(task.m_callable(data));
+        }
+    }
+
+    CallableType& m_callable;
+
+    std::optional<std::conditional_t<std::is_void_v<result_type>, char, result_type>> m_result;
+};
+
+/**
+ * @brief A publication slot on its own cache line, so that threads that are assigned different
+ * slots never write to the same cache line.
+ */
+template <typename DataType> struct alignas(cache_line_size) combining_slot
+{
+    std::atomic<combining_operation<DataType>*> operation{ nullptr };
+};
+} // namespace detail
+
+/**
+ * @brief A wrapper that guards its data by means of flat combining, which is suited to data that
+ * many threads apply small updates to (counters, statistics, and the like).
+ *
+ * Rather than every thread acquiring the mutex in turn, a thread that finds the mutex taken
+ * publishes its operation in one of `SlotCount` per-thread slots, and then keeps trying to acquire
+ * the mutex. Whichever thread holds the mutex acts as the combiner: it executes every published
+ * operation in a single batch, while the other threads merely wait for their result to be handed
+ * back. Under contention, this trades one lock hand-off (and the associated cache misses on the
+ * data) per operation for one per batch.
+ *
+ * Threads that map onto a slot that is already occupied, because there are more threads than
+ * slots, fall back to acquiring the mutex and executing their operation directly.
+ *
+ * The callable accepted by `with_lock_held(...)` mirrors that of `mutex_guarded<...>`, except that
+ * it may be invoked on a different thread, and that its result is returned by value.
+ */
+template <typename DataType, typename MutexType = std::mutex, std::size_t SlotCount = 64>
+class combining_guarded
+{
+    static_assert(
+        detail::traits::is_mutex<MutexType>::value, "The MutexType must support the Mutex concept");
+
+    static_assert(SlotCount > 0, "A combining_guarded<...> needs at least one slot.");
+
+  public:
+    using value_type = DataType;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using mutex_type = MutexType;
+
+    static constexpr std::size_t slot_count = SlotCount;
+
+    combining_guarded() = default;
+
+    combining_guarded(DataType data) : m_data{ std::move(data) }
+    {
+    }
+
+    combining_guarded(const combining_guarded&) = delete;
+    combining_guarded& operator=(const combining_guarded&) = delete;
+
+    /**
+     * @brief Executes the passed in functor with exclusive access to the data, either on the
+     * calling thread or on whichever thread currently holds the lock.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value. Any exception
+     *                                that it throws is rethrown on the calling thread.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> decltype(auto) with_lock_held(CallableType&& callable)
+    {
+        using task_type = detail::combining_task<DataType, std::remove_reference_t<CallableType>>;
+
+        static_assert(
+            !std::is_reference_v<typename task_type::result_type>,
+            "The result of a combined operation outlives the lock, so it can't be a reference.");
+
+        task_type task{ callable };
+
+        if (std::unique_lock<MutexType> guard{ m_mutex, std::try_to_lock }; guard.owns_lock()) {
+            // Without contention, there's no point in publishing the operation.
+            task.execute(m_data);
+            combine();
+        } else if (publish(task)) {
+            wait_or_combine(task);
+        } else {
+            guard.lock();
+            task.execute(m_data);
+            combine();
+        }
+
+        task.rethrow_if_failed();
+        return task.take_result();
+    }
+
+  private:
+    // The number of times that a waiting thread checks for its result before it tries to become
+    // the combiner again, which keeps the waiting threads from hammering the mutex.
+    static constexpr std::uint32_t polls_per_attempt = 16;
+
+    /**
+     * @brief Publishes the operation in the calling thread's slot.
+     *
+     * @returns False if the slot is occupied by another thread.
+     */
+    auto publish(detail::combining_operation<DataType>& operation) noexcept -> bool
+    {
+        auto& slot = m_slots[detail::thread_index() % SlotCount].operation;
+
+        detail::combining_operation<DataType>* vacant = nullptr;
+        return slot.compare_exchange_strong(
+            vacant, &operation, std::memory_order_release, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Waits for a combiner to execute the published operation, unless the calling thread
+     * manages to acquire the lock first, in which case it becomes the combiner itself.
+     */
+    void wait_or_combine(const detail::combining_operation<DataType>& operation)
+    {
+        for (std::uint32_t attempt = 0; !operation.is_done(); ++attempt) {
+            if (attempt % polls_per_attempt == 0) {
+                std::unique_lock<MutexType> guard{ m_mutex, std::try_to_lock };
+                if (guard.owns_lock()) {
+                    combine();
+                    return;
+                }
+            }
+
+            back_off(attempt);
+        }
+    }
+
+    /**
+     * @brief Executes all published operations. The mutex must be held.
+     */
+    void combine() noexcept
+    {
+        for (auto& slot : m_slots) {
+            if (!slot.operation.load(std::memory_order_relaxed)) {
+                continue;
+            }
+
+            // Vacate the slot before executing the operation, since the operation's publisher may
+            // publish its next operation as soon as this one is done.
+            auto* const operation = slot.operation.exchange(nullptr, std::memory_order_acquire);
+            if (operation) {
+                operation->execute(m_data);
+            }
+        }
+    }
+
+    /**
+     * @brief Spins for a little while, but periodically yields so that a combiner that was
+     * preempted in the middle of a batch gets a chance to finish.
+     */
+    static void back_off(std::uint32_t attempt) noexcept
+    {
+        if (attempt % 64 == 63) {
+            std::this_thread::yield();
+        } else {
+            detail::cpu_relax();
+        }
+    }
+
+    std::array<detail::combining_slot<DataType>, SlotCount> m_slots;
+
+    alignas(detail::cache_line_size) MutexType m_mutex;
+    DataType m_data;
+};
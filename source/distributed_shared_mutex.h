@@ -0,0 +1,315 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+
+namespace detail
+{
+/**
+ * @brief A reader indicator that lives on its own cache line, so that readers that are assigned
+ * different slots never write to the same cache line.
+ */
+struct alignas(cache_line_size) distributed_reader_slot
+{
+    std::atomic<std::uint32_t> readers{ 0 };
+};
+
+/**
+ * @brief A record of the fast-path read locks held by the calling thread, so that
+ * `unlock_shared()` can tell which path the matching `lock_shared()` took.
+ *
+ * Only a handful of records are kept; a thread that holds more fast-path read locks at once simply
+ * takes the slow path for the remainder.
+ */
+class distributed_reader_records
+{
+  public:
+    struct record
+    {
+        const void* mutex = nullptr;
+        std::uint32_t slot = 0;
+        std::uint32_t depth = 0;
+    };
+
+    static constexpr std::size_t capacity = 8;
+
+    /**
+     * @returns The record for the given mutex, or a free record if the calling thread doesn't hold
+     * a fast-path read lock on it, or null if no record is available.
+     */
+    static auto acquire(const void* mutex) noexcept -> record*
+    {
+        record* vacant = nullptr;
+        for (auto& entry : this_thread()) {
+            if (entry.mutex == mutex) {
+                return &entry;
+            }
+
+            if (!vacant && entry.depth == 0) {
+                vacant = &entry;
+            }
+        }
+
+        return vacant;
+    }
+
+    /**
+     * @returns The record for the given mutex, or null if the calling thread doesn't hold a
+     * fast-path read lock on it.
+     */
+    static auto find(const void* mutex) noexcept -> record*
+    {
+        for (auto& entry : this_thread()) {
+            if (entry.mutex == mutex && entry.depth > 0) {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+  private:
+    static auto this_thread() noexcept -> std::array<record, capacity>&
+    {
+        thread_local std::array<record, capacity> records;
+        return records;
+    }
+};
+} // namespace detail
+
+/**
+ * @brief A reader-writer mutex that lets readers scale across cores, based on the BRAVO ("Biased
+ * Locking for Reader-Writer Locks") design by Dice and Kogan.
+ *
+ * While the lock is reader-biased, readers merely increment a counter in one of `SlotCount`
+ * per-thread-hashed slots, each of which lives on its own cache line, so that readers on different
+ * cores don't contend. A writer first acquires the underlying mutex, then revokes the reader bias
+ * and waits for the slots to drain. Thereafter, readers fall back to the underlying mutex, until
+ * a reader re-enables the bias. To keep write-heavy workloads from paying for revocation over and
+ * over again, the bias stays off for a multiple of the time that the last revocation took.
+ *
+ * Read locks must be released by the thread that acquired them.
+ *
+ * This mutex satisfies the SharedMutex concept.
+ */
+template <typename UnderlyingMutexType = std::shared_mutex, std::size_t SlotCount = 64>
+class distributed_shared_mutex
+{
+    static_assert(
+        detail::traits::is_shared_mutex<UnderlyingMutexType>::value,
+        "The UnderlyingMutexType must support the SharedMutex concept");
+
+    static_assert(SlotCount > 0, "A distributed_shared_mutex needs at least one reader slot.");
+
+  public:
+    using underlying_mutex_type = UnderlyingMutexType;
+
+    static constexpr std::size_t slot_count = SlotCount;
+
+    distributed_shared_mutex() = default;
+
+    distributed_shared_mutex(const distributed_shared_mutex&) = delete;
+    distributed_shared_mutex& operator=(const distributed_shared_mutex&) = delete;
+
+    void lock()
+    {
+        m_mutex.lock();
+        revoke_bias();
+    }
+
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        if (!m_mutex.try_lock()) {
+            return false;
+        }
+
+        if (m_is_reader_biased.load(std::memory_order_relaxed)) {
+            m_is_reader_biased.store(false, std::memory_order_seq_cst);
+
+            // Rather than waiting for the readers to leave, give up right away.
+            if (!are_slots_empty()) {
+                m_mutex.unlock();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void unlock()
+    {
+        m_mutex.unlock();
+    }
+
+    void lock_shared()
+    {
+        if (try_lock_shared_fast()) {
+            return;
+        }
+
+        m_mutex.lock_shared();
+        restore_bias();
+    }
+
+    [[nodiscard]] auto try_lock_shared() -> bool
+    {
+        if (try_lock_shared_fast()) {
+            return true;
+        }
+
+        if (!m_mutex.try_lock_shared()) {
+            return false;
+        }
+
+        restore_bias();
+        return true;
+    }
+
+    void unlock_shared()
+    {
+        auto* const record = detail::distributed_reader_records::find(this);
+        if (!record) {
+            m_mutex.unlock_shared();
+            return;
+        }
+
+        m_slots[record->slot].readers.fetch_sub(1, std::memory_order_release);
+
+        if (--record->depth == 0) {
+            record->mutex = nullptr;
+        }
+    }
+
+    /**
+     * @returns True if readers currently take the fast path.
+     */
+    auto is_reader_biased() const noexcept -> bool
+    {
+        return m_is_reader_biased.load(std::memory_order_relaxed);
+    }
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+
+    // BRAVO suggests keeping the bias off for nine times as long as the revocation took, which
+    // bounds the overhead of revocation to about ten percent of the time spent writing.
+    static constexpr clock_type::rep inhibition_multiplier = 9;
+
+    auto try_lock_shared_fast() -> bool
+    {
+        auto* const record = detail::distributed_reader_records::acquire(this);
+        if (!record) {
+            return false;
+        }
+
+        // A recursive acquisition must not fall back to the underlying mutex, even if the bias has
+        // been revoked in the meantime: a writer may already hold it while waiting for our slot to
+        // drain. Since our slot can't drain before we release it anyway, the writer simply waits
+        // for both acquisitions to be released.
+        if (record->depth > 0) {
+            m_slots[record->slot].readers.fetch_add(1, std::memory_order_relaxed);
+            ++record->depth;
+
+            return true;
+        }
+
+        if (!m_is_reader_biased.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        const auto slot = slot_for_this_thread();
+        auto& readers = m_slots[slot].readers;
+
+        readers.fetch_add(1, std::memory_order_seq_cst);
+
+        // Pairs with the revocation in `revoke_bias()`: either the writer sees our increment, or we
+        // see that the bias has been revoked.
+        if (!m_is_reader_biased.load(std::memory_order_seq_cst)) {
+            readers.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        record->mutex = this;
+        record->slot = slot;
+        ++record->depth;
+
+        return true;
+    }
+
+    /**
+     * @brief Turns off the reader bias, and waits for the readers that took the fast path to
+     * leave. The underlying mutex must be held exclusively.
+     */
+    void revoke_bias()
+    {
+        if (!m_is_reader_biased.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const auto start = clock_type::now();
+
+        m_is_reader_biased.store(false, std::memory_order_seq_cst);
+
+        for (std::uint32_t attempt = 1; !are_slots_empty(); ++attempt) {
+            if (attempt % 64 == 0) {
+                std::this_thread::yield();
+            } else {
+                detail::cpu_relax();
+            }
+        }
+
+        const auto now = clock_type::now();
+        const auto inhibit_until =
+            now.time_since_epoch().count() + (now - start).count() * inhibition_multiplier;
+
+        m_inhibit_until.store(inhibit_until, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Turns the reader bias back on, unless a recent revocation says otherwise. The
+     * underlying mutex must be held in shared mode, which keeps writers out.
+     */
+    void restore_bias() noexcept
+    {
+        if (m_is_reader_biased.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const auto now = clock_type::now().time_since_epoch().count();
+        if (now >= m_inhibit_until.load(std::memory_order_relaxed)) {
+            // Publishes the writes of the previous writer, which we synchronized with through the
+            // underlying mutex, to the readers that will take the fast path.
+            m_is_reader_biased.store(true, std::memory_order_release);
+        }
+    }
+
+    auto are_slots_empty() const noexcept -> bool
+    {
+        for (const auto& slot : m_slots) {
+            if (slot.readers.load(std::memory_order_seq_cst) != 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static auto slot_for_this_thread() noexcept -> std::uint32_t
+    {
+        return detail::thread_index() % SlotCount;
+    }
+
+    std::array<detail::distributed_reader_slot, SlotCount> m_slots;
+
+    std::atomic<bool> m_is_reader_biased{ true };
+    std::atomic<clock_type::rep> m_inhibit_until{ 0 };
+
+    UnderlyingMutexType m_mutex;
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "mutex_guarded.h"
+#include "parking_lot.h"
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace detail
+{
+static_assert(
+    sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+        std::atomic<std::uint32_t>::is_always_lock_free,
+    "A futex word has to be a plain, lock-free 32-bit integer.");
+
+/**
+ * @brief Blocks the calling thread for as long as the word holds the expected value, or until it is
+ * woken up by `futex_wake_*(...)`. Spurious wake-ups are possible.
+ *
+ * On Linux, this maps directly onto the futex system call. Elsewhere, the thread is parked in the
+ * global `detail::parking_lot` instead, which offers the same semantics.
+ */
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept
+{
+#if defined(__linux__)
+    syscall(
+        SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr,
+        nullptr, 0);
+#else
+    parking_lot::park(&word, [&] { return word.load(std::memory_order_relaxed) == expected; });
+#endif
+}
+
+/**
+ * @brief Wakes up at most one thread that is blocked on the word.
+ */
+inline void futex_wake_one(std::atomic<std::uint32_t>& word) noexcept
+{
+#if defined(__linux__)
+    syscall(
+        SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr,
+        nullptr, 0);
+#else
+    parking_lot::unpark_all(&word);
+#endif
+}
+
+/**
+ * @brief Wakes up all threads that are blocked on the word.
+ */
+inline void futex_wake_all(std::atomic<std::uint32_t>& word) noexcept
+{
+#if defined(__linux__)
+    syscall(
+        SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr,
+        nullptr, 0);
+#else
+    parking_lot::unpark_all(&word);
+#endif
+}
+
+/**
+ * @brief The number of times that a thread re-checks a futex word before going to sleep.
+ */
+constexpr std::uint32_t futex_spin_count = 100;
+} // namespace detail
+
+/**
+ * @brief A mutex that consists of a single 32-bit word. Uncontended lock and unlock operations are
+ * a single atomic instruction each; contended threads briefly spin, and then sleep on a futex.
+ *
+ * At four bytes (as opposed to the forty bytes of a `std::mutex` on Linux), this mutex is well
+ * suited to large arrays of small `mutex_guarded<...>` instances.
+ *
+ * This mutex satisfies the Mutex concept.
+ */
+class futex_mutex
+{
+  public:
+    futex_mutex() = default;
+
+    futex_mutex(const futex_mutex&) = delete;
+    futex_mutex& operator=(const futex_mutex&) = delete;
+
+    void lock() noexcept
+    {
+        std::uint32_t state = unlocked;
+        if (m_state.compare_exchange_strong(
+                state, locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+
+        lock_slow();
+    }
+
+    [[nodiscard]] auto try_lock() noexcept -> bool
+    {
+        std::uint32_t state = unlocked;
+        return m_state.compare_exchange_strong(
+            state, locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        if (m_state.exchange(unlocked, std::memory_order_release) == locked_with_waiters) {
+            detail::futex_wake_one(m_state);
+        }
+    }
+
+  private:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t locked_with_waiters = 2;
+
+    void lock_slow() noexcept
+    {
+        for (std::uint32_t spin = 0; spin < detail::futex_spin_count; ++spin) {
+            detail::cpu_relax();
+
+            auto state = m_state.load(std::memory_order_relaxed);
+            if (state == locked_with_waiters) {
+                // Others are already sleeping, so there's no point in spinning any longer.
+                break;
+            }
+
+            if (state == unlocked &&
+                m_state.compare_exchange_weak(
+                    state, locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        // Since we can't tell whether other threads are sleeping, conservatively claim the lock in
+        // the `locked_with_waiters` state, so that our eventual unlock wakes them up.
+        while (m_state.exchange(locked_with_waiters, std::memory_order_acquire) != unlocked) {
+            detail::futex_wait(m_state, locked_with_waiters);
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{ unlocked };
+};
+
+/**
+ * @brief A reader-writer mutex that consists of a single 32-bit word. Waiting writers prevent new
+ * readers from acquiring the lock, so that a steady stream of readers can't starve writers.
+ *
+ * This mutex satisfies the SharedMutex concept.
+ */
+class futex_shared_mutex
+{
+  public:
+    futex_shared_mutex() = default;
+
+    futex_shared_mutex(const futex_shared_mutex&) = delete;
+    futex_shared_mutex& operator=(const futex_shared_mutex&) = delete;
+
+    void lock() noexcept
+    {
+        if (try_lock()) {
+            return;
+        }
+
+        // Hold off new readers while we wait.
+        m_state.fetch_add(pending_writer, std::memory_order_relaxed);
+        lock_slow(can_write, [this] { return try_lock_as_pending_writer(); });
+    }
+
+    [[nodiscard]] auto try_lock() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        return can_write(state) &&
+               m_state.compare_exchange_strong(
+                   state, state | writer, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        const auto previous = m_state.fetch_and(~(writer | waiters), std::memory_order_release);
+
+        if (previous & waiters) {
+            detail::futex_wake_all(m_state);
+        }
+    }
+
+    void lock_shared() noexcept
+    {
+        if (try_lock_shared()) {
+            return;
+        }
+
+        lock_slow(can_read, [this] { return try_lock_shared(); });
+    }
+
+    [[nodiscard]] auto try_lock_shared() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        while (can_read(state)) {
+            if (m_state.compare_exchange_weak(
+                    state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void unlock_shared() noexcept
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        auto next = state;
+
+        do {
+            // The last reader out clears the waiters flag and wakes everyone up, in a single
+            // atomic step, so that threads that go to sleep afterwards set the flag anew.
+            next = state - 1;
+            if ((state & reader_mask) == 1) {
+                next &= ~waiters;
+            }
+        } while (!m_state.compare_exchange_weak(
+            state, next, std::memory_order_release, std::memory_order_relaxed));
+
+        if ((state & waiters) && !(next & waiters)) {
+            detail::futex_wake_all(m_state);
+        }
+    }
+
+  private:
+    // The state word packs a writer flag, a flag that indicates that threads are sleeping, a count
+    // of writers waiting for the lock, and a count of readers holding the lock.
+    static constexpr std::uint32_t writer = 1u << 31;
+    static constexpr std::uint32_t waiters = 1u << 30;
+    static constexpr std::uint32_t pending_writer = 1u << 20;
+    static constexpr std::uint32_t pending_writer_mask = 0x3FFu << 20;
+    static constexpr std::uint32_t reader_mask = pending_writer - 1;
+
+    static auto can_write(std::uint32_t state) noexcept -> bool
+    {
+        return (state & (writer | reader_mask)) == 0;
+    }
+
+    static auto can_read(std::uint32_t state) noexcept -> bool
+    {
+        return (state & (writer | pending_writer_mask)) == 0;
+    }
+
+    /**
+     * @brief Acquires write access on behalf of a writer that has registered itself as pending.
+     */
+    auto try_lock_as_pending_writer() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order_relaxed);
+        while (can_write(state)) {
+            if (m_state.compare_exchange_weak(
+                    state, (state - pending_writer) | writer, std::memory_order_acquire,
+                    std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Spins for a little while, and then sleeps until the lock can be acquired.
+     */
+    template <typename PredicateType, typename AcquireType>
+    void lock_slow(PredicateType can_acquire, AcquireType try_acquire) noexcept
+    {
+        for (std::uint32_t spin = 0; spin < detail::futex_spin_count; ++spin) {
+            detail::cpu_relax();
+
+            if (try_acquire()) {
+                return;
+            }
+        }
+
+        while (true) {
+            auto state = m_state.load(std::memory_order_relaxed);
+            if (can_acquire(state)) {
+                if (try_acquire()) {
+                    return;
+                }
+
+                continue;
+            }
+
+            // Announce that we're about to sleep, unless the state changed in the meantime.
+            if (!(state & waiters) &&
+                !m_state.compare_exchange_weak(
+                    state, state | waiters, std::memory_order_relaxed)) {
+                continue;
+            }
+
+            detail::futex_wait(m_state, state | waiters);
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{ 0 };
+};
+
+static_assert(sizeof(futex_mutex) == 4, "A futex_mutex should consist of a single 32-bit word.");
+static_assert(
+    sizeof(futex_shared_mutex) == 4,
+    "A futex_shared_mutex should consist of a single 32-bit word.");
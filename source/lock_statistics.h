@@ -0,0 +1,625 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A histogram of durations, with logarithmically sized buckets: bucket `i` counts durations
+ * of at least `2^i - 1` and less than `2^(i + 1) - 1` nanoseconds, and the last bucket also counts
+ * all longer durations.
+ */
+struct lock_histogram
+{
+    static constexpr std::size_t bucket_count = 40;
+
+    std::array<std::uint64_t, bucket_count> buckets{};
+
+    /**
+     * @returns The index of the bucket that counts the given duration.
+     */
+    static auto bucket_for(std::chrono::nanoseconds duration) noexcept -> std::size_t
+    {
+        auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0)) + 1;
+
+        std::size_t bucket = 0;
+        while (value > 1 && bucket + 1 < bucket_count) {
+            value >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+
+    /**
+     * @returns The smallest duration that the given bucket counts.
+     */
+    static auto lower_bound(std::size_t bucket) noexcept -> std::chrono::nanoseconds
+    {
+        return std::chrono::nanoseconds{ (std::int64_t{ 1 } << bucket) - 1 };
+    }
+
+    /**
+     * @returns The number of recorded durations.
+     */
+    auto count() const noexcept -> std::uint64_t
+    {
+        std::uint64_t total = 0;
+        for (const auto bucket : buckets) {
+            total += bucket;
+        }
+
+        return total;
+    }
+
+    /**
+     * @returns An upper bound on the given percentile (between zero and one hundred) of the
+     * recorded durations, to within a factor of two.
+     */
+    auto percentile(double percentile) const noexcept -> std::chrono::nanoseconds
+    {
+        const auto total = count();
+        if (total == 0) {
+            return std::chrono::nanoseconds{ 0 };
+        }
+
+        const auto rank = static_cast<std::uint64_t>(percentile / 100.0 * (total - 1)) + 1;
+
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket + 1 < bucket_count; ++bucket) {
+            seen += buckets[bucket];
+            if (seen >= rank) {
+                return lower_bound(bucket + 1);
+            }
+        }
+
+        return lower_bound(bucket_count - 1);
+    }
+};
+
+/**
+ * @brief The statistics of a single guard, aggregated over all threads.
+ */
+struct lock_statistics_snapshot
+{
+    std::string name;
+
+    /**
+     * @brief The number of times that the lock was acquired.
+     */
+    std::uint64_t acquisitions = 0;
+
+    /**
+     * @brief The number of acquisitions for which the lock could not be acquired right away. This
+     * is a subset of the acquisitions, so the contention ratio never exceeds one.
+     */
+    std::uint64_t contended = 0;
+
+    /**
+     * @brief The number of non-blocking or timed attempts that gave up without acquiring the lock.
+     * These are not counted as acquisitions.
+     */
+    std::uint64_t failed = 0;
+
+    /**
+     * @brief The time spent waiting for contended acquisitions.
+     */
+    lock_histogram wait_time;
+
+    /**
+     * @brief The time for which the lock was held.
+     */
+    lock_histogram hold_time;
+};
+
+namespace detail
+{
+/**
+ * @brief The statistics of a single guard, as recorded by a single thread.
+ *
+ * Only the owning thread ever writes to a block, and each block lives on its own cache line(s), so
+ * recording never involves a write to memory that another thread writes to as well. The counters
+ * are atomic only so that they can be read while they're being updated.
+ */
+struct alignas(cache_line_size) lock_statistics_block
+{
+    using counter_type = std::atomic<std::uint64_t>;
+
+    static void increment(counter_type& counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    counter_type acquisitions{ 0 };
+    counter_type contended{ 0 };
+    counter_type failed{ 0 };
+    std::array<counter_type, lock_histogram::bucket_count> wait_time{};
+    std::array<counter_type, lock_histogram::bucket_count> hold_time{};
+
+    // The thread that records into this block. Set once, before the block is published.
+    std::thread::id owner;
+    lock_statistics_block* next = nullptr;
+};
+} // namespace detail
+
+class lock_statistics_registry;
+
+/**
+ * @brief The statistics of a single guard. Each instance registers itself with the
+ * `lock_statistics_registry` for as long as it lives.
+ */
+class guard_statistics
+{
+  public:
+    inline guard_statistics();
+    inline ~guard_statistics() noexcept;
+
+    guard_statistics(const guard_statistics&) = delete;
+    guard_statistics& operator=(const guard_statistics&) = delete;
+
+    /**
+     * @brief Sets the name under which the statistics are reported.
+     */
+    inline void set_name(std::string name);
+
+    /**
+     * @returns The name under which the statistics are reported.
+     */
+    inline auto name() const -> std::string;
+
+    /**
+     * @returns The statistics recorded so far, aggregated over all threads.
+     */
+    inline auto snapshot() const -> lock_statistics_snapshot;
+
+    void record_acquisition(bool was_contended, std::chrono::nanoseconds wait_time)
+    {
+        auto& block = block_for_this_thread();
+
+        detail::lock_statistics_block::increment(block.acquisitions);
+
+        if (was_contended) {
+            detail::lock_statistics_block::increment(block.contended);
+            detail::lock_statistics_block::increment(
+                block.wait_time[lock_histogram::bucket_for(wait_time)]);
+        }
+    }
+
+    void record_failure()
+    {
+        auto& block = block_for_this_thread();
+
+        detail::lock_statistics_block::increment(block.failed);
+    }
+
+    void record_release(std::chrono::nanoseconds hold_time)
+    {
+        auto& block = block_for_this_thread();
+
+        detail::lock_statistics_block::increment(
+            block.hold_time[lock_histogram::bucket_for(hold_time)]);
+    }
+
+  private:
+    friend class lock_statistics_registry;
+
+    inline auto snapshot_with_registry_locked() const -> lock_statistics_snapshot;
+
+    /**
+     * @returns The block into which the calling thread records its statistics for this guard.
+     *
+     * Each guard owns its blocks, one per thread that has used it, and a thread finds its block by
+     * walking that list, so no per-thread state outlives the guard. The lookup is cached by a
+     * process-wide unique identifier rather than by address, so that a new guard that happens to
+     * reuse the address of a destroyed one never picks up one of its blocks.
+     */
+    auto block_for_this_thread() -> detail::lock_statistics_block&
+    {
+        // Most threads keep working with the same guard for a while, so remember the last lookup.
+        thread_local std::pair<std::uint64_t, detail::lock_statistics_block*> last_lookup{
+            0, nullptr
+        };
+
+        if (last_lookup.first == m_id) {
+            return *last_lookup.second;
+        }
+
+        const auto thread = std::this_thread::get_id();
+
+        auto* block = m_blocks.load(std::memory_order_acquire);
+        while (block && block->owner != thread) {
+            block = block->next;
+        }
+
+        // Only this thread ever adds a block that it owns, so there's no race to add one twice.
+        if (!block) {
+            block = new detail::lock_statistics_block;
+            block->owner = thread;
+            block->next = m_blocks.load(std::memory_order_relaxed);
+
+            while (!m_blocks.compare_exchange_weak(
+                block->next, block, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+
+        last_lookup = { m_id, block };
+        return *block;
+    }
+
+    static auto next_id() noexcept -> std::uint64_t
+    {
+        // Zero is never handed out, since it marks an empty lookup cache.
+        static std::atomic<std::uint64_t> id{ 1 };
+        return id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const std::uint64_t m_id = next_id();
+
+    std::string m_name;
+    std::atomic<detail::lock_statistics_block*> m_blocks{ nullptr };
+};
+
+/**
+ * @brief A process-wide registry of the statistics of all guards that use the `lock_statistics`
+ * policy, which can be dumped on demand.
+ */
+class lock_statistics_registry
+{
+  public:
+    static auto instance() -> lock_statistics_registry&
+    {
+        static lock_statistics_registry registry;
+        return registry;
+    }
+
+    lock_statistics_registry(const lock_statistics_registry&) = delete;
+    lock_statistics_registry& operator=(const lock_statistics_registry&) = delete;
+
+    /**
+     * @returns The statistics of all live guards, sorted by name.
+     */
+    auto snapshot() const -> std::vector<lock_statistics_snapshot>
+    {
+        std::vector<lock_statistics_snapshot> snapshots;
+
+        {
+            const std::lock_guard<std::mutex> guard{ m_mutex };
+            for (const auto* statistics : m_guards) {
+                snapshots.push_back(statistics->snapshot_with_registry_locked());
+            }
+        }
+
+        std::sort(snapshots.begin(), snapshots.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.name < rhs.name;
+        });
+
+        return snapshots;
+    }
+
+    /**
+     * @brief Writes the statistics of all live guards as a JSON array, with one object per guard.
+     * Each histogram is written as an array of bucket counts; see `lock_histogram`.
+     */
+    void dump_json(std::ostream& stream) const
+    {
+        const auto write_histogram = [&](const lock_histogram& histogram) {
+            stream << '[';
+            for (std::size_t bucket = 0; bucket < lock_histogram::bucket_count; ++bucket) {
+                stream << (bucket ? "," : "") << histogram.buckets[bucket];
+            }
+
+            stream << ']';
+        };
+
+        stream << '[';
+
+        bool is_first = true;
+        for (const auto& snapshot : snapshot()) {
+            stream << (is_first ? "" : ",") << "\n  {\"name\":";
+            write_json_string(stream, snapshot.name);
+            stream << ",\"acquisitions\":" << snapshot.acquisitions
+                   << ",\"contended\":" << snapshot.contended << ",\"failed\":" << snapshot.failed
+                   << ",\"wait_time_ns\":";
+            write_histogram(snapshot.wait_time);
+            stream << ",\"hold_time_ns\":";
+            write_histogram(snapshot.hold_time);
+            stream << '}';
+
+            is_first = false;
+        }
+
+        stream << (is_first ? "]" : "\n]") << '\n';
+    }
+
+    /**
+     * @brief Writes a human-readable summary of the statistics of all live guards, with one line
+     * per guard.
+     */
+    void dump_text(std::ostream& stream) const
+    {
+        for (const auto& snapshot : snapshot()) {
+            const auto contention = snapshot.acquisitions
+                                        ? 100.0 * snapshot.contended / snapshot.acquisitions
+                                        : 0.0;
+
+            stream << snapshot.name << ": " << snapshot.acquisitions << " acquisitions, "
+                   << snapshot.contended << " contended (" << contention << "%), "
+                   << snapshot.failed << " failed, wait p50 <= "
+                   << snapshot.wait_time.percentile(50).count() << "ns, wait p99 <= "
+                   << snapshot.wait_time.percentile(99).count() << "ns, hold p50 <= "
+                   << snapshot.hold_time.percentile(50).count() << "ns, hold p99 <= "
+                   << snapshot.hold_time.percentile(99).count() << "ns\n";
+        }
+    }
+
+  private:
+    friend class guard_statistics;
+
+    lock_statistics_registry() = default;
+
+    static void write_json_string(std::ostream& stream, const std::string& string)
+    {
+        stream << '"';
+        for (const auto character : string) {
+            switch (character) {
+            case '"':
+                stream << "\\\"";
+                break;
+            case '\\':
+                stream << "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+                    stream << escaped;
+                } else {
+                    stream << character;
+                }
+            }
+        }
+
+        stream << '"';
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<const guard_statistics*> m_guards;
+};
+
+guard_statistics::guard_statistics() : m_name{ "guard#" + std::to_string(m_id) }
+{
+    auto& registry = lock_statistics_registry::instance();
+
+    const std::lock_guard<std::mutex> guard{ registry.m_mutex };
+    registry.m_guards.push_back(this);
+}
+
+guard_statistics::~guard_statistics() noexcept
+{
+    {
+        auto& registry = lock_statistics_registry::instance();
+
+        const std::lock_guard<std::mutex> guard{ registry.m_mutex };
+        auto& guards = registry.m_guards;
+        guards.erase(std::find(guards.begin(), guards.end(), this));
+    }
+
+    auto* block = m_blocks.load(std::memory_order_acquire);
+    while (block) {
+        delete std::exchange(block, block->next);
+    }
+}
+
+void guard_statistics::set_name(std::string name)
+{
+    // The name is guarded by the registry's mutex, since that's what dumps hold while reading it.
+    auto& registry = lock_statistics_registry::instance();
+
+    const std::lock_guard<std::mutex> guard{ registry.m_mutex };
+    m_name = std::move(name);
+}
+
+auto guard_statistics::name() const -> std::string
+{
+    auto& registry = lock_statistics_registry::instance();
+
+    const std::lock_guard<std::mutex> guard{ registry.m_mutex };
+    return m_name;
+}
+
+auto guard_statistics::snapshot() const -> lock_statistics_snapshot
+{
+    auto& registry = lock_statistics_registry::instance();
+
+    const std::lock_guard<std::mutex> guard{ registry.m_mutex };
+    return snapshot_with_registry_locked();
+}
+
+auto guard_statistics::snapshot_with_registry_locked() const -> lock_statistics_snapshot
+{
+    lock_statistics_snapshot snapshot;
+    snapshot.name = m_name;
+
+    for (auto* block = m_blocks.load(std::memory_order_acquire); block; block = block->next) {
+        snapshot.acquisitions += block->acquisitions.load(std::memory_order_relaxed);
+        snapshot.contended += block->contended.load(std::memory_order_relaxed);
+        snapshot.failed += block->failed.load(std::memory_order_relaxed);
+
+        for (std::size_t bucket = 0; bucket < lock_histogram::bucket_count; ++bucket) {
+            snapshot.wait_time.buckets[bucket] +=
+                block->wait_time[bucket].load(std::memory_order_relaxed);
+            snapshot.hold_time.buckets[bucket] +=
+                block->hold_time[bucket].load(std::memory_order_relaxed);
+        }
+    }
+
+    return snapshot;
+}
+
+/**
+ * @brief A statistics policy that records, for every guard:
+ *
+ *  - the number of lock acquisitions;
+ *  - the number of acquisitions that were contended (that is, where the first attempt failed);
+ *  - the number of non-blocking or timed attempts that gave up without acquiring the lock;
+ *  - a histogram of the time spent waiting for contended acquisitions; and
+ *  - a histogram of the time for which the lock was held.
+ *
+ * The statistics are accessible through the guard's `statistics()` function, and through the
+ * `lock_statistics_registry`.
+ *
+ * Usage:
+ *
+ *     mutex_guarded<std::vector<int>, std::mutex, compact_layout, lock_statistics> data;
+ *     data.statistics().set_name("pending requests");
+ */
+struct lock_statistics
+{
+    static constexpr bool is_enabled = true;
+
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * @brief The state that the policy adds to each guard.
+     */
+    class storage
+    {
+      public:
+        auto statistics() const noexcept -> guard_statistics&
+        {
+            return m_statistics;
+        }
+
+      private:
+        mutable guard_statistics m_statistics;
+    };
+
+    /**
+     * @brief Acquires the lock using the given lock policy, and records the acquisition.
+     *
+     * @returns The time at which the lock was acquired.
+     */
+    template <typename LockPolicyType, typename MutexType>
+    static auto lock(MutexType& mutex, guard_statistics& statistics) -> clock_type::time_point
+    {
+        if (LockPolicyType::try_lock(mutex)) {
+            statistics.record_acquisition(false, {});
+            return clock_type::now();
+        }
+
+        const auto start = clock_type::now();
+        LockPolicyType::lock(mutex);
+        const auto now = clock_type::now();
+
+        statistics.record_acquisition(true, now - start);
+        return now;
+    }
+
+    /**
+     * @brief Makes a single, non-blocking attempt to acquire the lock using the given lock policy,
+     * and records the outcome.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename LockPolicyType, typename MutexType>
+    static auto try_lock(
+        MutexType& mutex, guard_statistics& statistics, clock_type::time_point& acquired_at)
+        -> bool
+    {
+        if (!LockPolicyType::try_lock(mutex)) {
+            statistics.record_failure();
+            return false;
+        }
+
+        statistics.record_acquisition(false, {});
+        acquired_at = clock_type::now();
+        return true;
+    }
+
+    /**
+     * @brief Attempts to acquire the lock using the given timed lock policy, and records the
+     * outcome.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename LockPolicyType, typename MutexType, typename ChronoType>
+    static auto try_lock_for(
+        MutexType& mutex, const ChronoType& timeout, guard_statistics& statistics,
+        clock_type::time_point& acquired_at) -> bool
+    {
+        return try_lock_with<LockPolicyType>(mutex, statistics, acquired_at, [&] {
+            return LockPolicyType::lock(mutex, timeout);
+        });
+    }
+
+    /**
+     * @brief Attempts to acquire the lock using the given lock policy until the deadline passes,
+     * and records the outcome.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename LockPolicyType, typename MutexType, typename TimePointType>
+    static auto try_lock_until(
+        MutexType& mutex, const TimePointType& deadline, guard_statistics& statistics,
+        clock_type::time_point& acquired_at) -> bool
+    {
+        return try_lock_with<LockPolicyType>(mutex, statistics, acquired_at, [&] {
+            return LockPolicyType::lock_until(mutex, deadline);
+        });
+    }
+
+    /**
+     * @brief Releases the lock using the given lock policy, and records how long it was held.
+     */
+    template <typename LockPolicyType, typename MutexType>
+    static void unlock(
+        MutexType& mutex, guard_statistics& statistics, clock_type::time_point acquired_at)
+    {
+        const auto hold_time = clock_type::now() - acquired_at;
+        LockPolicyType::unlock(mutex);
+
+        statistics.record_release(hold_time);
+    }
+
+  private:
+    /**
+     * @brief Makes a non-blocking attempt first, so that uncontended acquisitions aren't timed,
+     * and then falls back to the given blocking attempt.
+     */
+    template <typename LockPolicyType, typename MutexType, typename AttemptType>
+    static auto try_lock_with(
+        MutexType& mutex, guard_statistics& statistics, clock_type::time_point& acquired_at,
+        AttemptType&& attempt) -> bool
+    {
+        if (LockPolicyType::try_lock(mutex)) {
+            statistics.record_acquisition(false, {});
+            acquired_at = clock_type::now();
+            return true;
+        }
+
+        const auto start = clock_type::now();
+        const auto was_locked = attempt();
+        const auto now = clock_type::now();
+
+        if (!was_locked) {
+            statistics.record_failure();
+            return false;
+        }
+
+        statistics.record_acquisition(true, now - start);
+        acquired_at = now;
+        return true;
+    }
+};
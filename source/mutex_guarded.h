@@ -1,12 +1,66 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
+#include <new>
 #include <optional>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace detail
 {
+/**
+ * @brief The assumed size of a cache line, in bytes.
+ *
+ * GCC warns about every use of `std::hardware_destructive_interference_size`, since its value
+ * depends on the tuning flags and would thus make the size of `mutex_guarded<...>` part of the ABI.
+ * Define `MUTEX_GUARDED_CACHE_LINE_SIZE` to override the value.
+ */
+#if defined(MUTEX_GUARDED_CACHE_LINE_SIZE)
+constexpr std::size_t cache_line_size = MUTEX_GUARDED_CACHE_LINE_SIZE;
+#elif defined(__cpp_lib_hardware_interference_size) && !defined(__GNUC__)
+constexpr std::size_t cache_line_size = std::hardware_destructive_interference_size;
+#else
+constexpr std::size_t cache_line_size = 64;
+#endif
+
+/**
+ * @brief Hints to the processor that the calling thread is spinning, which frees up resources for
+ * a sibling hyper-thread and reduces the penalty for leaving the spin loop.
+ */
+inline void cpu_relax() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @returns A small integer that identifies the calling thread. Consecutive threads are assigned
+ * consecutive numbers, which spreads them over per-thread slots more evenly than a hash would.
+ */
+inline auto thread_index() noexcept -> std::uint32_t
+{
+    static std::atomic<std::uint32_t> next_index{ 0 };
+    thread_local const std::uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
 namespace traits
 {
 template <typename, typename = void> struct is_mutex : std::false_type
@@ -56,6 +110,43 @@ struct is_timed_mutex<
                    std::declval<std::chrono::seconds>()))>> : std::true_type
 {
 };
+
+template <typename, typename = void> struct is_upgrade_mutex : std::false_type
+{
+};
+
+template <typename MutexType>
+struct is_upgrade_mutex<
+    MutexType, std::void_t<
+                   decltype(std::declval<MutexType>().lock_upgrade()),
+                   decltype(std::declval<MutexType>().try_lock_upgrade()),
+                   decltype(std::declval<MutexType>().unlock_upgrade()),
+                   decltype(std::declval<MutexType>().unlock_upgrade_and_lock()),
+                   decltype(std::declval<MutexType>().unlock_and_lock_shared())>> : std::true_type
+{
+};
+
+template <typename, typename = void> struct is_async_mutex : std::false_type
+{
+};
+
+template <typename MutexType>
+struct is_async_mutex<MutexType, std::void_t<decltype(std::declval<MutexType>().async_lock())>>
+    : std::true_type
+{
+};
+
+template <typename, typename = void> struct is_async_shared_mutex : std::false_type
+{
+};
+
+template <typename MutexType>
+struct is_async_shared_mutex<
+    MutexType, std::void_t<
+                   decltype(std::declval<MutexType>().async_lock()),
+                   decltype(std::declval<MutexType>().async_lock_shared())>> : std::true_type
+{
+};
 } // namespace traits
 
 namespace mutex_category
@@ -64,6 +155,7 @@ struct unique;
 struct shared;
 struct unique_and_timed;
 struct shared_and_timed;
+struct upgrade;
 } // namespace mutex_category
 
 /**
@@ -158,37 +250,81 @@ struct mutex_traits_impl<MutexType, mutex_category::shared_and_timed>
     }
 };
 
-template <bool IsMutex, bool IsSharedMutex, bool IsTimedMutex, bool IsSharedTimedMutex>
+/**
+ * @brief Partial specialization for upgradeable lock traits.
+ */
+template <typename MutexType>
+struct mutex_traits_impl<MutexType, mutex_category::upgrade>
+    : mutex_traits_impl<MutexType, mutex_category::shared>
+{
+    static void lock_upgrade(MutexType& mutex)
+    {
+        mutex.lock_upgrade();
+    }
+
+    [[nodiscard]] static bool try_lock_upgrade(MutexType& mutex)
+    {
+        return mutex.try_lock_upgrade();
+    }
+
+    static void unlock_upgrade(MutexType& mutex)
+    {
+        mutex.unlock_upgrade();
+    }
+
+    static void unlock_upgrade_and_lock(MutexType& mutex)
+    {
+        mutex.unlock_upgrade_and_lock();
+    }
+
+    static void unlock_and_lock_shared(MutexType& mutex)
+    {
+        mutex.unlock_and_lock_shared();
+    }
+};
+
+template <
+    bool IsMutex, bool IsSharedMutex, bool IsTimedMutex, bool IsSharedTimedMutex,
+    bool IsUpgradeMutex>
 struct mutex_tagger
 {
 };
 
-template <> struct mutex_tagger<true, false, false, false>
+template <> struct mutex_tagger<true, false, false, false, false>
 {
     using type = mutex_category::unique;
 };
 
-template <> struct mutex_tagger<true, true, false, false>
+template <> struct mutex_tagger<true, true, false, false, false>
 {
     using type = mutex_category::shared;
 };
 
-template <> struct mutex_tagger<true, false, true, false>
+template <> struct mutex_tagger<true, false, true, false, false>
 {
     using type = mutex_category::unique_and_timed;
 };
 
-template <> struct mutex_tagger<true, true, true, true>
+template <> struct mutex_tagger<true, true, true, true, false>
 {
     using type = mutex_category::shared_and_timed;
 };
 
+template <bool IsTimedMutex, bool IsSharedTimedMutex>
+struct mutex_tagger<true, true, IsTimedMutex, IsSharedTimedMutex, true>
+{
+    // Upgrade support takes precedence over timed locking; an upgradeable guard only exposes the
+    // untimed interface.
+    using type = mutex_category::upgrade;
+};
+
 template <typename MutexType>
 using detect_mutex_category = typename mutex_tagger<
-    traits::is_mutex<MutexType>::value,                     //< E.g., std::mutex
-    traits::is_shared_mutex<MutexType>::value,              //< E.g., std::shared_mutex
-    traits::is_timed_mutex<MutexType>::value,               //< E.g., std::timed_mutex
-    traits::is_timed_shared_mutex<MutexType>::value>::type; //< E.g., std::shared_timed_mutex
+    traits::is_mutex<MutexType>::value,               //< E.g., std::mutex
+    traits::is_shared_mutex<MutexType>::value,        //< E.g., std::shared_mutex
+    traits::is_timed_mutex<MutexType>::value,         //< E.g., std::timed_mutex
+    traits::is_timed_shared_mutex<MutexType>::value,  //< E.g., std::shared_timed_mutex
+    traits::is_upgrade_mutex<MutexType>::value>::type; //< E.g., boost::upgrade_mutex
 
 /**
  * @brief Mutex traits, as derived from the detected functionality of the mutex.
@@ -201,6 +337,51 @@ struct mutex_traits : mutex_traits_impl<MutexType, detect_mutex_category<MutexTy
     using mutex_type = MutexType;
 };
 
+/**
+ * @brief Emulates a timed lock acquisition on top of a non-blocking one, for mutexes that don't
+ * support timed locking natively. The calling thread spins briefly, then yields, and then sleeps
+ * for exponentially increasing periods, none of which extend past the deadline.
+ *
+ * @param[in] deadline            The point in time at which to give up.
+ * @param[in] try_lock            A callable that makes a single, non-blocking attempt.
+ *
+ * @returns True if the lock was acquired before the deadline passed.
+ */
+template <typename TimePointType, typename TryLockType>
+auto emulate_lock_until(const TimePointType& deadline, TryLockType&& try_lock) -> bool
+{
+    using clock_type = typename TimePointType::clock;
+
+    constexpr std::uint32_t spin_count = 64;
+    constexpr std::uint32_t yield_count = 16;
+    constexpr auto longest_sleep = std::chrono::milliseconds{ 1 };
+
+    auto sleep = std::chrono::duration_cast<typename clock_type::duration>(
+        std::chrono::microseconds{ 1 });
+
+    for (std::uint32_t attempt = 0;; ++attempt) {
+        if (try_lock()) {
+            return true;
+        }
+
+        const auto now = clock_type::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+        if (attempt < spin_count) {
+            cpu_relax();
+        } else if (attempt < spin_count + yield_count) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::min<typename clock_type::duration>(
+                sleep, deadline - now));
+
+            sleep = std::min<typename clock_type::duration>(sleep * 2, longest_sleep);
+        }
+    }
+}
+
 /**
  * @brief A locking policy targeted at mutexes that comply with the Mutex concept.
  *
@@ -216,6 +397,25 @@ struct unique_lock_policy
         mutex_traits<MutexType>::lock(mutex);
     }
 
+    template <typename MutexType> [[nodiscard]] static bool try_lock(MutexType& mutex)
+    {
+        return mutex_traits<MutexType>::try_lock(mutex);
+    }
+
+    /**
+     * @brief Attempts to acquire the lock until the deadline passes, natively if the mutex
+     * supports the TimedMutex concept, and through `emulate_lock_until(...)` otherwise.
+     */
+    template <typename MutexType, typename TimePointType>
+    [[nodiscard]] static bool lock_until(MutexType& mutex, const TimePointType& deadline)
+    {
+        if constexpr (traits::is_timed_mutex<MutexType>::value) {
+            return mutex_traits<MutexType>::try_lock_until(mutex, deadline);
+        } else {
+            return emulate_lock_until(deadline, [&] { return try_lock(mutex); });
+        }
+    }
+
     template <typename MutexType> static void unlock(MutexType& mutex)
     {
         mutex_traits<MutexType>::unlock(mutex);
@@ -242,6 +442,25 @@ struct shared_lock_policy
         mutex_traits<MutexType>::lock_shared(mutex);
     }
 
+    template <typename MutexType> [[nodiscard]] static bool try_lock(MutexType& mutex)
+    {
+        return mutex_traits<MutexType>::try_lock_shared(mutex);
+    }
+
+    /**
+     * @brief Attempts to acquire the lock until the deadline passes, natively if the mutex
+     * supports the SharedTimedMutex concept, and through `emulate_lock_until(...)` otherwise.
+     */
+    template <typename MutexType, typename TimePointType>
+    [[nodiscard]] static bool lock_until(MutexType& mutex, const TimePointType& deadline)
+    {
+        if constexpr (traits::is_timed_shared_mutex<MutexType>::value) {
+            return mutex_traits<MutexType>::try_lock_shared_until(mutex, deadline);
+        } else {
+            return emulate_lock_until(deadline, [&] { return try_lock(mutex); });
+        }
+    }
+
     template <typename MutexType> static void unlock(MutexType& mutex)
     {
         static_assert(
@@ -274,6 +493,11 @@ struct timed_unique_lock_policy
         return mutex_traits<MutexType>::try_lock_for(mutex, timeout);
     }
 
+    template <typename MutexType> [[nodiscard]] static bool try_lock(MutexType& mutex)
+    {
+        return mutex_traits<MutexType>::try_lock(mutex);
+    }
+
     template <typename MutexType> static void unlock(MutexType& mutex)
     {
         static_assert(
@@ -306,6 +530,11 @@ struct timed_shared_lock_policy
         return mutex_traits<MutexType>::try_lock_shared_for(mutex, timeout);
     }
 
+    template <typename MutexType> [[nodiscard]] static bool try_lock(MutexType& mutex)
+    {
+        return mutex_traits<MutexType>::try_lock_shared(mutex);
+    }
+
     template <typename MutexType> static void unlock(MutexType& mutex)
     {
         static_assert(
@@ -316,177 +545,1404 @@ struct timed_shared_lock_policy
         mutex_traits<MutexType>::unlock_shared(mutex);
     }
 };
-} // namespace detail
 
 /**
- * @brief A RAII proxy that allows the guarded data to be accessed only after the associated mutex
- * has been locked.
+ * @brief A locking policy targeted at mutexes that support upgradeable locks, such as
+ * `boost::upgrade_mutex`. An upgradeable lock coexists with shared locks, but excludes other
+ * upgradeable and exclusive locks, so that it can later be upgraded to an exclusive lock without
+ * being released in between.
+ *
+ * Function mapping:
+ *
+ *     lock()   --> lock_upgrade()
+ *     unlock() --> unlock_upgrade()
  */
-template <
-    typename BaseType,
-    typename LockPolicyType =
-        typename detail::mutex_traits<typename BaseType::mutex_type>::category_type>
-class [[nodiscard]] lock_proxy
+struct upgrade_lock_policy
 {
-  public:
-    using value_type = typename BaseType::value_type;
-
-    using pointer = value_type*;
-    using const_pointer = const value_type*;
-
-    using reference = value_type&;
-    using const_reference = const value_type&;
-
-    lock_proxy(BaseType* base) : m_base{ base }
+    template <typename MutexType> static void lock(MutexType& mutex)
     {
-        assert(base);
+        static_assert(
+            traits::is_upgrade_mutex<MutexType>::value,
+            "The upgrade_lock_policy expects to operate on a mutex that supports upgradeable "
+            "locking.");
 
-        LockPolicyType::lock(m_base->m_mutex);
+        mutex_traits<MutexType>::lock_upgrade(mutex);
     }
 
-    template <typename ChronoType> lock_proxy(BaseType* base, const ChronoType& timeout)
+    template <typename MutexType> [[nodiscard]] static bool try_lock(MutexType& mutex)
     {
-        assert(base);
+        static_assert(
+            traits::is_upgrade_mutex<MutexType>::value,
+            "The upgrade_lock_policy expects to operate on a mutex that supports upgradeable "
+            "locking.");
 
-        const auto wasLocked = LockPolicyType::lock(base->m_mutex, timeout);
-        m_base = wasLocked ? base : nullptr;
+        return mutex_traits<MutexType>::try_lock_upgrade(mutex);
     }
 
-    ~lock_proxy() noexcept
+    template <typename MutexType, typename TimePointType>
+    [[nodiscard]] static bool lock_until(MutexType& mutex, const TimePointType& deadline)
     {
-        if (m_base) {
-            LockPolicyType::unlock(m_base->m_mutex);
-        }
+        return emulate_lock_until(deadline, [&] { return try_lock(mutex); });
     }
 
-    auto is_locked() const -> bool
+    template <typename MutexType> static void unlock(MutexType& mutex)
     {
-        return m_base != nullptr;
-    }
+        static_assert(
+            traits::is_upgrade_mutex<MutexType>::value,
+            "The upgrade_lock_policy expects to operate on a mutex that supports upgradeable "
+            "locking.");
 
-    auto operator->() noexcept -> pointer
-    {
-        return &m_base->m_data;
+        mutex_traits<MutexType>::unlock_upgrade(mutex);
     }
+};
+} // namespace detail
 
-    auto operator->() const noexcept -> const_pointer
-    {
-        return &m_base->m_data;
-    }
+/**
+ * @brief The default statistics policy, which records nothing and adds neither code nor data to
+ * `mutex_guarded<...>` or its proxies. See `lock_statistics` for the alternative.
+ */
+struct no_statistics
+{
+    static constexpr bool is_enabled = false;
 
-    auto operator*() noexcept -> reference
+    struct storage
     {
-        return m_base->m_data;
-    }
+    };
+};
 
-    auto operator*() const noexcept -> const_reference
+namespace detail
+{
+template <typename BaseType, typename = void> struct statistics_policy_of
+{
+    using type = no_statistics;
+};
+
+template <typename BaseType>
+struct statistics_policy_of<BaseType, std::void_t<typename BaseType::statistics_policy>>
+{
+    using type = typename BaseType::statistics_policy;
+};
+
+} // namespace detail
+
+/**
+ * @brief The default notification policy, which adds no condition variable to
+ * `mutex_guarded<...>`. See `condition_notification` for the alternative.
+ */
+struct no_notification
+{
+    static constexpr bool is_enabled = false;
+
+    template <typename MutexType> struct storage
     {
-        return m_base->m_data;
-    }
+    };
+};
 
-  private:
-    std::conditional_t<
-        std::is_const_v<BaseType>, std::add_pointer_t<const BaseType>, std::add_pointer_t<BaseType>>
-        m_base = nullptr;
+namespace detail
+{
+template <typename BaseType, typename = void> struct notification_policy_of
+{
+    using type = no_notification;
+};
+
+template <typename BaseType>
+struct notification_policy_of<BaseType, std::void_t<typename BaseType::notification_policy>>
+{
+    using type = typename BaseType::notification_policy;
+};
+} // namespace detail
+
+/**
+ * @brief The default versioning policy, which keeps no write version and adds neither code nor
+ * data to `mutex_guarded<...>` or its proxies. See `write_versioning` for the alternative.
+ */
+struct no_versioning
+{
+    static constexpr bool is_enabled = false;
+    static constexpr bool publishes_changes = false;
+
+    struct storage
+    {
+    };
 };
 
 namespace detail
 {
-template <typename DerivedType, typename DataType, typename TagType> class mutex_guarded_impl
+template <typename BaseType, typename = void> struct versioning_policy_of
+{
+    using type = no_versioning;
+};
+
+template <typename BaseType>
+struct versioning_policy_of<BaseType, std::void_t<typename BaseType::versioning_policy>>
 {
+    using type = typename BaseType::versioning_policy;
 };
 
 /**
- * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
- * the Mutex concept.
+ * @brief The moment at which a proxy acquired its lock, which is only tracked if statistics are
+ * being recorded.
  */
-template <typename DerivedType, typename DataType>
-class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique>
+template <bool IsEnabled> struct lock_proxy_timestamp
 {
-  public:
-    using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
+};
 
-    using const_unique_lock_proxy = const lock_proxy<const DerivedType, detail::unique_lock_policy>;
+template <> struct lock_proxy_timestamp<true>
+{
+    // Mutable, so that a waiting proxy can record when it reacquired its lock.
+    mutable std::chrono::steady_clock::time_point m_acquired_at;
+};
 
-    /**
-     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
-     *
-     * @returns An RAII proxy.
-     */
-    auto lock() -> unique_lock_proxy
+template <typename DerivedType, typename DataType, typename TagType> class mutex_guarded_impl;
+
+/**
+ * @brief Instructs a `lock_proxy<...>` to adopt a lock that the caller has already acquired,
+ * rather than acquiring one itself.
+ */
+template <typename BaseType> struct adopted_lock
+{
+    BaseType* base;
+};
+
+/**
+ * @brief The guard that a `lock_proxy<...>` is associated with, and whether the proxy currently
+ * holds its lock. The flag is stored in the lowest bit of the pointer, so that a proxy is no larger
+ * than a pointer, unless the guard's alignment leaves no bit to spare.
+ */
+template <typename BaseType, bool HasSpareBit = (alignof(BaseType) > 1)> class proxy_base_pointer
+{
+  public:
+    proxy_base_pointer() noexcept = default;
+
+    proxy_base_pointer(BaseType* base, bool is_locked) noexcept
+        : m_value{ reinterpret_cast<std::uintptr_t>(base) | static_cast<std::uintptr_t>(is_locked) }
     {
-        return { static_cast<DerivedType*>(this) };
     }
 
-    /**
-     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
-     *
-     * @returns An RAII proxy.
-     */
-    auto lock() const -> const_unique_lock_proxy
+    auto get() const noexcept -> BaseType*
     {
-        return { static_cast<const DerivedType*>(this) };
+        return reinterpret_cast<BaseType*>(m_value & ~locked_bit);
     }
 
-    /**
-     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
-     * held.
-     *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type must take its input parameter
-     *                                by reference; avoid taking input by value.
-     *
-     * @returns The result of invoking the functor.
-     */
-    template <typename CallableType>
-    [[nodiscard]] auto with_lock_held(CallableType&& callable) -> std::enable_if_t<
-        !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
-        decltype(callable(std::declval<DataType&>()))>
+    auto is_locked() const noexcept -> bool
     {
-        const auto guard = lock();
-        return callable(static_cast<DerivedType*>(this)->m_data);
+        return (m_value & locked_bit) != 0;
     }
 
-    /**
-     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
-     * held.
-     *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type should take its input parameter
-     *                                by const reference. Failure to do so will result in
-     *                                compilation failure.
-     */
-    template <typename CallableType>
-    auto with_lock_held(CallableType&& callable) -> std::enable_if_t<
-        std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
+    void set_locked(bool is_locked) noexcept
     {
-        const auto guard = lock();
-        callable(static_cast<DerivedType*>(this)->m_data);
+        m_value = (m_value & ~locked_bit) | static_cast<std::uintptr_t>(is_locked);
     }
 
-    /**
-     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
-     * held.
-     *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type should take its input parameter
+  private:
+    static constexpr std::uintptr_t locked_bit = 1;
+
+    std::uintptr_t m_value = 0;
+};
+
+template <typename BaseType> class proxy_base_pointer<BaseType, false>
+{
+  public:
+    proxy_base_pointer() noexcept = default;
+
+    proxy_base_pointer(BaseType* base, bool is_locked) noexcept
+        : m_base{ base }, m_is_locked{ is_locked }
+    {
+    }
+
+    auto get() const noexcept -> BaseType*
+    {
+        return m_base;
+    }
+
+    auto is_locked() const noexcept -> bool
+    {
+        return m_is_locked;
+    }
+
+    void set_locked(bool is_locked) noexcept
+    {
+        m_is_locked = is_locked;
+    }
+
+  private:
+    BaseType* m_base = nullptr;
+    bool m_is_locked = false;
+};
+} // namespace detail
+
+template <
+    typename DataType, typename MutexType, typename LayoutPolicy, typename StatisticsPolicy,
+    typename NotificationPolicy, typename VersioningPolicy>
+class mutex_guarded;
+
+/**
+ * @brief A RAII proxy that allows the guarded data to be accessed only after the associated mutex
+ * has been locked.
+ *
+ * A proxy is move-only: moving it transfers the lock, if any, to the new proxy. While a proxy stays
+ * associated with its guard, its lock can be dropped early through `unlock()` and acquired again
+ * through `relock()` or `try_relock()`.
+ */
+template <
+    typename BaseType,
+    typename LockPolicyType =
+        typename detail::mutex_traits<typename BaseType::mutex_type>::category_type>
+class [[nodiscard]] lock_proxy
+    : private detail::lock_proxy_timestamp<
+          detail::statistics_policy_of<std::remove_const_t<BaseType>>::type::is_enabled>
+{
+    using statistics_policy =
+        typename detail::statistics_policy_of<std::remove_const_t<BaseType>>::type;
+
+    using notification_policy =
+        typename detail::notification_policy_of<std::remove_const_t<BaseType>>::type;
+
+    using versioning_policy =
+        typename detail::versioning_policy_of<std::remove_const_t<BaseType>>::type;
+
+  public:
+    using value_type = typename BaseType::value_type;
+
+    // A proxy to a const-qualified base only ever grants const access to the data, and so does an
+    // upgradeable proxy, since other threads may be reading the data at the same time.
+    static constexpr bool is_read_only =
+        std::is_const_v<BaseType> || std::is_same_v<LockPolicyType, detail::upgrade_lock_policy>;
+
+    using pointer = std::conditional_t<is_read_only, const value_type*, value_type*>;
+    using const_pointer = const value_type*;
+
+    using reference = std::conditional_t<is_read_only, const value_type&, value_type&>;
+    using const_reference = const value_type&;
+
+    lock_proxy(BaseType* base) : m_base{ base, false }
+    {
+        assert(base);
+        relock();
+    }
+
+    template <typename ChronoType> lock_proxy(BaseType* base, const ChronoType& timeout)
+    {
+        assert(base);
+
+        bool wasLocked = false;
+        if constexpr (statistics_policy::is_enabled) {
+            wasLocked = statistics_policy::template try_lock_for<LockPolicyType>(
+                base->m_mutex, timeout, base->statistics(), this->m_acquired_at);
+        } else {
+            wasLocked = LockPolicyType::lock(base->m_mutex, timeout);
+        }
+
+        m_base = { base, wasLocked };
+    }
+
+    /**
+     * @brief Makes a single, non-blocking attempt to acquire the lock.
+     */
+    lock_proxy(BaseType* base, std::try_to_lock_t) : m_base{ base, false }
+    {
+        assert(base);
+        [[maybe_unused]] const auto wasLocked = try_relock();
+    }
+
+    /**
+     * @brief Associates the proxy with the guard, without acquiring the lock just yet; see
+     * `relock()` and `try_relock()`.
+     */
+    lock_proxy(BaseType* base, std::defer_lock_t) noexcept : m_base{ base, false }
+    {
+        assert(base);
+    }
+
+    /**
+     * @brief Attempts to acquire the lock until the deadline passes.
+     */
+    template <typename ClockType, typename DurationType>
+    lock_proxy(BaseType* base, const std::chrono::time_point<ClockType, DurationType>& deadline)
+    {
+        assert(base);
+
+        bool wasLocked = false;
+        if constexpr (statistics_policy::is_enabled) {
+            wasLocked = statistics_policy::template try_lock_until<LockPolicyType>(
+                base->m_mutex, deadline, base->statistics(), this->m_acquired_at);
+        } else {
+            wasLocked = LockPolicyType::lock_until(base->m_mutex, deadline);
+        }
+
+        m_base = { base, wasLocked };
+    }
+
+    lock_proxy(detail::adopted_lock<BaseType> adopted) : m_base{ adopted.base, true }
+    {
+        assert(adopted.base);
+
+        if constexpr (statistics_policy::is_enabled) {
+            // The caller acquired the lock on our behalf, so we can't tell whether it contended.
+            adopted.base->statistics().record_acquisition(false, {});
+            this->m_acquired_at = std::chrono::steady_clock::now();
+        }
+    }
+
+    lock_proxy(lock_proxy&& other) noexcept
+        : detail::lock_proxy_timestamp<statistics_policy::is_enabled>{ other },
+          m_base{ std::exchange(other.m_base, {}) }
+    {
+    }
+
+    auto operator=(lock_proxy&& other) noexcept -> lock_proxy&
+    {
+        if (this != &other) {
+            if (m_base.is_locked()) {
+                unlock();
+            }
+
+            static_cast<detail::lock_proxy_timestamp<statistics_policy::is_enabled>&>(*this) =
+                other;
+            m_base = std::exchange(other.m_base, {});
+        }
+
+        return *this;
+    }
+
+    lock_proxy(const lock_proxy&) = delete;
+    lock_proxy& operator=(const lock_proxy&) = delete;
+
+    ~lock_proxy() noexcept
+    {
+        if (m_base.is_locked()) {
+            unlock();
+        }
+    }
+
+    auto is_locked() const -> bool
+    {
+        return m_base.is_locked();
+    }
+
+    /**
+     * @brief Releases the lock ahead of the proxy's destruction, e.g., as soon as the guarded data
+     * is no longer needed. The proxy stays associated with its guard, so that the lock can be
+     * reacquired through `relock()`. The data must not be accessed through the proxy until then.
+     */
+    void unlock() noexcept
+    {
+        assert(m_base.is_locked());
+        record_write();
+        release_lock();
+
+        m_base.set_locked(false);
+        publish_changes();
+    }
+
+    /**
+     * @brief Blocks until the lock that was released through `unlock()`, or deferred at
+     * construction, has been acquired again. The data may have changed in the meantime.
+     */
+    void relock()
+    {
+        assert(m_base.get() && !m_base.is_locked());
+        acquire_lock();
+
+        m_base.set_locked(true);
+    }
+
+    /**
+     * @brief Makes a single, non-blocking attempt to acquire the lock that was released through
+     * `unlock()`, or deferred at construction.
+     *
+     * @returns True if the proxy holds the lock now.
+     */
+    [[nodiscard]] auto try_relock() -> bool
+    {
+        assert(m_base.get() && !m_base.is_locked());
+
+        bool wasLocked = false;
+        if constexpr (statistics_policy::is_enabled) {
+            wasLocked = statistics_policy::template try_lock<LockPolicyType>(
+                m_base.get()->m_mutex, m_base.get()->statistics(), this->m_acquired_at);
+        } else {
+            wasLocked = LockPolicyType::try_lock(m_base.get()->m_mutex);
+        }
+
+        m_base.set_locked(wasLocked);
+        return wasLocked;
+    }
+
+    /**
+     * @brief Hands off the held lock without releasing it, and disassociates the proxy from its
+     * guard. The lock stays held until a proxy of the same type adopts it, by being constructed
+     * from the returned token. Moving the proxy is simpler, where possible.
+     *
+     * @returns A token that a new proxy can be constructed from.
+     */
+    auto release() -> detail::adopted_lock<BaseType>
+    {
+        return { transition([](auto&) {}) };
+    }
+
+    /**
+     * @brief Atomically upgrades an upgradeable lock to an exclusive lock, blocking until all
+     * readers have released their locks. The lock is never released in between, so the data can't
+     * have changed since it was last inspected through this proxy.
+     *
+     * Afterwards, this proxy no longer holds a lock.
+     *
+     * @returns An RAII proxy that holds an exclusive lock.
+     */
+    template <
+        typename PolicyType = LockPolicyType,
+        typename = std::enable_if_t<std::is_same_v<PolicyType, detail::upgrade_lock_policy>>>
+    auto upgrade() -> lock_proxy<BaseType, detail::unique_lock_policy>
+    {
+        return detail::adopted_lock<BaseType>{ transition([](auto& mutex) {
+            detail::mutex_traits<std::decay_t<decltype(mutex)>>::unlock_upgrade_and_lock(mutex);
+        }) };
+    }
+
+    /**
+     * @brief Atomically downgrades an exclusive lock to a shared lock, such that no other writer
+     * can modify the data in between.
+     *
+     * Afterwards, this proxy no longer holds a lock.
+     *
+     * @returns An RAII proxy that holds a shared lock.
+     */
+    template <
+        typename PolicyType = LockPolicyType,
+        typename = std::enable_if_t<
+            std::is_same_v<PolicyType, detail::unique_lock_policy> &&
+            detail::traits::is_upgrade_mutex<typename BaseType::mutex_type>::value>>
+    auto downgrade() -> lock_proxy<const BaseType, detail::shared_lock_policy>
+    {
+        record_write();
+        return detail::adopted_lock<const BaseType>{ transition([](auto& mutex) {
+            detail::mutex_traits<std::decay_t<decltype(mutex)>>::unlock_and_lock_shared(mutex);
+        }) };
+    }
+
+    /**
+     * @brief Releases the lock, and blocks until the guarded data satisfies the predicate. The
+     * predicate is only ever evaluated with the lock held, and the lock is held again once this
+     * function returns. Only available if the guard was declared with the `condition_notification`
+     * policy (see `waitable_guarded<...>`).
+     *
+     * @param[in] predicate           A callable that takes the data by const reference, and
+     *                                returns true once the wait is over.
+     */
+    template <
+        typename PredicateType, typename B = BaseType,
+        typename = std::enable_if_t<
+            detail::notification_policy_of<std::remove_const_t<B>>::type::is_enabled>>
+    void wait(PredicateType&& predicate) const
+    {
+        assert(m_base.is_locked());
+        release_writes_before_waiting(predicate);
+
+        auto* const base = m_base.get();
+        notification_policy::template wait<LockPolicyType>(
+            base->condition(), base->m_mutex,
+            [&] { return predicate(std::as_const(base->m_data)); });
+    }
+
+    /**
+     * @brief Releases the lock, and blocks until the guarded data satisfies the predicate, or until
+     * the timeout expires. Either way, the lock is held again once this function returns.
+     *
+     * @param[in] timeout             The maximum amount of time to wait for.
+     * @param[in] predicate           A callable that takes the data by const reference, and
+     *                                returns true once the wait is over.
+     *
+     * @returns The result of the final evaluation of the predicate.
+     */
+    template <
+        typename ChronoType, typename PredicateType, typename B = BaseType,
+        typename = std::enable_if_t<
+            detail::notification_policy_of<std::remove_const_t<B>>::type::is_enabled>>
+    auto wait_for(const ChronoType& timeout, PredicateType&& predicate) const -> bool
+    {
+        return wait_until(
+            std::chrono::steady_clock::now() + timeout, std::forward<PredicateType>(predicate));
+    }
+
+    /**
+     * @brief Releases the lock, and blocks until the guarded data satisfies the predicate, or until
+     * the deadline passes. Either way, the lock is held again once this function returns.
+     *
+     * @param[in] deadline            The point in time at which to give up.
+     * @param[in] predicate           A callable that takes the data by const reference, and
+     *                                returns true once the wait is over.
+     *
+     * @returns The result of the final evaluation of the predicate.
+     */
+    template <
+        typename TimePointType, typename PredicateType, typename B = BaseType,
+        typename = std::enable_if_t<
+            detail::notification_policy_of<std::remove_const_t<B>>::type::is_enabled>>
+    auto wait_until(const TimePointType& deadline, PredicateType&& predicate) const -> bool
+    {
+        assert(m_base.is_locked());
+        release_writes_before_waiting(predicate);
+
+        auto* const base = m_base.get();
+        return notification_policy::template wait_until<LockPolicyType>(
+            base->condition(), base->m_mutex, deadline,
+            [&] { return predicate(std::as_const(base->m_data)); });
+    }
+
+    auto operator->() noexcept -> pointer
+    {
+        assert(m_base.is_locked());
+        return &m_base.get()->m_data;
+    }
+
+    auto operator->() const noexcept -> const_pointer
+    {
+        assert(m_base.is_locked());
+        return &m_base.get()->m_data;
+    }
+
+    auto operator*() noexcept -> reference
+    {
+        assert(m_base.is_locked());
+        return m_base.get()->m_data;
+    }
+
+    auto operator*() const noexcept -> const_reference
+    {
+        assert(m_base.is_locked());
+        return m_base.get()->m_data;
+    }
+
+  private:
+    template <typename S, typename D, typename T> friend class detail::mutex_guarded_impl;
+
+    template <typename D, typename M, typename L, typename S, typename N, typename V>
+    friend class mutex_guarded;
+
+    /**
+     * @brief Advances the guard's write version, if it keeps one, before a proxy that grants write
+     * access lets go of its lock, since the data may have been modified through the proxy.
+     */
+    void record_write() const noexcept
+    {
+        if constexpr (versioning_policy::is_enabled && !is_read_only) {
+            m_base.get()->advance_version();
+        }
+    }
+
+    /**
+     * @brief Notifies the guard's subscribers, if it has any, of the writes that have been
+     * released so far. Called by every proxy once it has let go of its lock, including read-only
+     * ones, since a downgraded proxy only releases its lock after the write has been recorded.
+     */
+    void publish_changes() const noexcept
+    {
+        if constexpr (versioning_policy::publishes_changes) {
+            m_base.get()->publish_changes();
+        }
+    }
+
+    /**
+     * @brief Releases the lock without recording a write, for when the guard knows that the data
+     * hasn't been modified through the proxy, such as after a failed optimistic update.
+     */
+    void unlock_unmodified() noexcept
+    {
+        assert(m_base.is_locked());
+        release_lock();
+
+        m_base.set_locked(false);
+    }
+
+    /**
+     * @brief Records the writes made through the proxy before it starts waiting. If the guard
+     * publishes its changes, and the predicate doesn't hold yet, the lock is released once and
+     * the subscribers are notified, just as in `unlock()`: the condition variable releases the lock
+     * without telling the proxy, and once the wait is over, the lock is held again.
+     */
+    template <typename PredicateType>
+    void release_writes_before_waiting(PredicateType& predicate) const
+    {
+        record_write();
+
+        if constexpr (versioning_policy::publishes_changes && !is_read_only) {
+            auto* const base = m_base.get();
+            if (predicate(std::as_const(base->m_data))) {
+                return;
+            }
+
+            release_lock();
+            publish_changes();
+
+            // Write access implies an exclusive lock, which doesn't need a timeout to reacquire.
+            acquire_lock();
+        }
+    }
+
+    /**
+     * @brief Releases the mutex, and records how long it was held, if the guard keeps statistics.
+     * Doesn't record a write, and leaves it to the caller to update the proxy's state.
+     */
+    void release_lock() const noexcept
+    {
+        auto* const base = m_base.get();
+        if constexpr (statistics_policy::is_enabled) {
+            statistics_policy::template unlock<LockPolicyType>(
+                base->m_mutex, base->statistics(), this->m_acquired_at);
+        } else {
+            LockPolicyType::unlock(base->m_mutex);
+        }
+    }
+
+    /**
+     * @brief Blocks until the mutex has been acquired, and records the acquisition, if the guard
+     * keeps statistics. Leaves it to the caller to update the proxy's state.
+     */
+    void acquire_lock() const
+    {
+        auto* const base = m_base.get();
+        if constexpr (statistics_policy::is_enabled) {
+            this->m_acquired_at =
+                statistics_policy::template lock<LockPolicyType>(base->m_mutex, base->statistics());
+        } else {
+            LockPolicyType::lock(base->m_mutex);
+        }
+    }
+
+    /**
+     * @brief Converts the held lock into a different kind of lock, and hands it off to the caller.
+     *
+     * @returns The base, which this proxy is no longer associated with.
+     */
+    template <typename TransitionType> auto transition(TransitionType&& transition) -> BaseType*
+    {
+        assert(m_base.is_locked());
+
+        auto* const base = m_base.get();
+        if constexpr (statistics_policy::is_enabled) {
+            base->statistics().record_release(
+                std::chrono::steady_clock::now() - this->m_acquired_at);
+        }
+
+        transition(base->m_mutex);
+        m_base = {};
+        return base;
+    }
+
+    detail::proxy_base_pointer<BaseType> m_base;
+};
+
+namespace detail
+{
+/**
+ * @brief The result of a `try_with_*_held(...)` function: whether the functor was invoked, if it
+ * returns void, or an optional that holds its result otherwise.
+ */
+template <typename ResultType>
+using try_result_t =
+    std::conditional_t<std::is_void_v<ResultType>, bool, std::optional<ResultType>>;
+
+/**
+ * @brief Invokes the functor on the guarded data, provided that the proxy holds a lock.
+ */
+template <typename ProxyType, typename CallableType>
+auto invoke_if_locked(ProxyType& proxy, CallableType& callable)
+    -> try_result_t<std::invoke_result_t<CallableType&, typename ProxyType::reference>>
+{
+    using result_type = std::invoke_result_t<CallableType&, typename ProxyType::reference>;
+
+    if (!proxy.is_locked()) {
+        return {};
+    }
+
+    if constexpr (std::is_void_v<result_type>) {
+        callable(*proxy);
+        return true;
+    } else {
+        return callable(*proxy);
+    }
+}
+
+template <typename DerivedType, typename DataType, typename TagType> class mutex_guarded_impl
+{
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
+ * the Mutex concept.
+ */
+template <typename DerivedType, typename DataType>
+class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique>
+{
+  public:
+    using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
+
+    using const_unique_lock_proxy = const lock_proxy<const DerivedType, detail::unique_lock_policy>;
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
+     *
+     * @returns An RAII proxy.
+     */
+    auto lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
+     *
+     * @returns An RAII proxy.
+     */
+    auto lock() const -> const_unique_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
+     * held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto with_lock_held(CallableType&& callable) -> std::enable_if_t<
+        !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
+        decltype(callable(std::declval<DataType&>()))>
+    {
+        const auto guard = lock();
+        return callable(static_cast<DerivedType*>(this)->m_data);
+    }
+
+    /**
+     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
+     * held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference. Failure to do so will result in
+     *                                compilation failure.
+     */
+    template <typename CallableType>
+    auto with_lock_held(CallableType&& callable) -> std::enable_if_t<
+        std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
+    {
+        const auto guard = lock();
+        callable(static_cast<DerivedType*>(this)->m_data);
+    }
+
+    /**
+     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
+     * held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference. Failure to do so will result in
+     *                                compilation failure.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto with_lock_held(CallableType&& callable) const -> std::enable_if_t<
+        !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
+        decltype(callable(std::declval<DataType&>()))>
+    {
+        const auto guard = lock();
+        return callable(static_cast<const DerivedType*>(this)->m_data);
+    }
+
+    /**
+     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
+     * held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference. Failure to do so will result in
+     *                                compilation failure.
+     */
+    template <typename CallableType>
+    auto with_lock_held(CallableType&& callable) const -> std::enable_if_t<
+        std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
+    {
+        const auto guard = lock();
+        callable(static_cast<const DerivedType*>(this)->m_data);
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_lock() const -> const_unique_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired before the timeout expires.
+     *
+     * The mutex doesn't support timed locking natively, so the lock is acquired by polling it
+     * with a bounded back-off.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename ChronoType> auto try_lock_for(const ChronoType& timeout) -> unique_lock_proxy
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired before the timeout expires.
+     *
+     * The mutex doesn't support timed locking natively, so the lock is acquired by polling it
+     * with a bounded back-off.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename ChronoType>
+    auto try_lock_for(const ChronoType& timeout) const -> const_unique_lock_proxy
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        return { static_cast<const DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired before the deadline passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_lock_until(const TimePointType& deadline) -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired before the deadline passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_lock_until(const TimePointType& deadline) const -> const_unique_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired without blocking.
+     *
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto try_with_lock_held(CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_lock();
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired without blocking.
+     *
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto try_with_lock_held(CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_lock();
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the timeout expires.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_lock_for(timeout);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the timeout expires.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_for(
+        const ChronoType& timeout, CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_lock_for(timeout);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
+ * the TimedMutex concept.
+ */
+template <typename DerivedType, typename DataType>
+class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique_and_timed>
+{
+  public:
+    using timed_lock_proxy = lock_proxy<DerivedType, detail::timed_unique_lock_policy>;
+
+    using const_timed_lock_proxy =
+        const lock_proxy<const DerivedType, detail::timed_unique_lock_policy>;
+
+    using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
+
+    using const_unique_lock_proxy = const lock_proxy<const DerivedType, detail::unique_lock_policy>;
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
+     *
+     * @returns An RAII proxy.
+     */
+    auto lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
+     *
+     * @returns An RAII proxy.
+     */
+    auto lock() const -> const_unique_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex
+     * using the specified timeout.
+     *
+     * @returns An RAII proxy.
+     */
+    template <typename ChronoType> auto try_lock_for(const ChronoType& timeout) -> timed_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), timeout };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex
+     * using the specified timeout.
+     *
+     * @returns An RAII proxy.
+     */
+    template <typename ChronoType>
+    auto try_lock_for(const ChronoType& timeout) const -> const_timed_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), timeout };
+    }
+
+    /**
+     * @brief Executes the functor only if the mutex can be locked before the timer expires.
+     *
+     * This function will be enabled if the functor's return type is void.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if a lock was acquired on the mutex; false otherwise.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable)
+        -> std::enable_if_t<
+            std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, bool>
+    {
+        const auto guard = try_lock_for(timeout);
+        if (guard.is_locked()) {
+            callable(static_cast<DerivedType*>(this)->m_data);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Executes the functor only if the mutex can be locked before the timer expires.
+     *
+     * This function will be enabled if the functor's return type is not void.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns An optional containing the result of invoking the functor if a lock on the
+     * mutex was obtained. If the lock could not be obtained, an empty optional is returned
+     * instead.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable)
+        -> std::enable_if_t<
+            !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
+            std::optional<decltype(callable(std::declval<DataType&>()))>>
+    {
+        const auto guard = try_lock_for(timeout);
+        if (guard.is_locked()) {
+            return callable(static_cast<DerivedType*>(this)->m_data);
+        }
+
+        return {};
+    }
+
+    /**
+     * @brief Executes the functor only if the mutex can be locked before the timer expires.
+     *
+     * This function will be enabled if the functor's return type is void.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if a lock was acquired on the mutex; false otherwise.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
+        -> std::enable_if_t<
+            std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, bool>
+    {
+        const auto guard = try_lock_for(timeout);
+        if (guard.is_locked()) {
+            callable(static_cast<const DerivedType*>(this)->m_data);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Executes the functor only if the mutex can be locked before the timer expires.
+     *
+     * This function will be enabled if the functor's return type is not void.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns An optional containing the result of invoking the functor if a lock on the
+     * mutex was obtained. If the lock could not be obtained, an empty optional is returned
+     * instead.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
+        -> std::enable_if_t<
+            !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
+            std::optional<decltype(callable(std::declval<DataType&>()))>>
+    {
+        const auto guard = try_lock_for(timeout);
+        if (guard.is_locked()) {
+            return callable(static_cast<const DerivedType*>(this)->m_data);
+        }
+
+        return {};
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_lock() const -> const_unique_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired before the deadline passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_lock_until(const TimePointType& deadline) -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex,
+     * provided that the lock can be acquired before the deadline passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_lock_until(const TimePointType& deadline) const -> const_unique_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired without blocking.
+     *
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto try_with_lock_held(CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_lock();
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired without blocking.
+     *
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto try_with_lock_held(CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_lock();
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
+ * the SharedMutex concept.
+ */
+template <typename DerivedType, typename DataType>
+class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::shared>
+{
+  public:
+    using shared_lock_proxy = const lock_proxy<const DerivedType, detail::shared_lock_policy>;
+
+    using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an exclusive
+     * lock on the underlying mutex.
+     *
+     * @returns An RAII proxy.
+     */
+    auto write_lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release a shared
+     * lock on the underlying mutex.
+     *
+     * @returns An RAII proxy.
+     */
+    auto read_lock() const -> shared_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Grabs an exclusive lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto with_write_lock_held(CallableType&& callable) -> std::enable_if_t<
+        !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
+        decltype(callable(std::declval<DataType&>()))>
+    {
+        const auto guard = write_lock();
+        return callable(static_cast<DerivedType*>(this)->m_data);
+    }
+
+    /**
+     * @brief Grabs an exclusive lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     */
+    template <typename CallableType>
+    auto with_write_lock_held(CallableType&& callable) -> std::enable_if_t<
+        std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
+    {
+        const auto guard = write_lock();
+        callable(static_cast<DerivedType*>(this)->m_data);
+    }
+
+    /**
+     * @brief Grabs a shared lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
      *                                by const reference. Failure to do so will result in
      *                                compilation failure.
      *
      * @returns The result of invoking the functor.
      */
     template <typename CallableType>
-    [[nodiscard]] auto with_lock_held(CallableType&& callable) const -> std::enable_if_t<
+    [[nodiscard]] auto with_read_lock_held(CallableType&& callable) const -> std::enable_if_t<
         !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
         decltype(callable(std::declval<DataType&>()))>
     {
-        const auto guard = lock();
+        const auto guard = read_lock();
         return callable(static_cast<const DerivedType*>(this)->m_data);
     }
 
     /**
-     * @brief Locks the underlying mutex, and then executes the passed in functor with the lock
-     * held.
+     * @brief Grabs a shared lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held.
      *
      * @param[in] callable            A callable type like a lambda, std::function, etc.
      *                                This callable type should take its input parameter
@@ -494,70 +1950,423 @@ class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique>
      *                                compilation failure.
      */
     template <typename CallableType>
-    auto with_lock_held(CallableType&& callable) const -> std::enable_if_t<
+    auto with_read_lock_held(CallableType&& callable) const -> std::enable_if_t<
         std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
     {
-        const auto guard = lock();
+        const auto guard = read_lock();
         callable(static_cast<const DerivedType*>(this)->m_data);
     }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an exclusive lock on
+     * the underlying mutex, provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_write_lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release a shared lock on the
+     * underlying mutex, provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_read_lock() const -> shared_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an exclusive lock on
+     * the underlying mutex, provided that the lock can be acquired before the timeout expires.
+     *
+     * The mutex doesn't support timed locking natively, so the lock is acquired by polling it
+     * with a bounded back-off.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename ChronoType>
+    auto try_write_lock_for(const ChronoType& timeout) -> unique_lock_proxy
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release a shared lock on the
+     * underlying mutex, provided that the lock can be acquired before the timeout expires.
+     *
+     * The mutex doesn't support timed locking natively, so the lock is acquired by polling it
+     * with a bounded back-off.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename ChronoType>
+    auto try_read_lock_for(const ChronoType& timeout) const -> shared_lock_proxy
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        return { static_cast<const DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an exclusive lock on
+     * the underlying mutex, provided that the lock can be acquired before the deadline passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_write_lock_until(const TimePointType& deadline) -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release a shared lock on the
+     * underlying mutex, provided that the lock can be acquired before the deadline passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_read_lock_until(const TimePointType& deadline) const -> shared_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired without blocking.
+     *
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto try_with_write_lock_held(CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_write_lock();
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired without blocking.
+     *
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto try_with_read_lock_held(CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_read_lock();
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the timeout expires.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_write_lock_held_for(
+        const ChronoType& timeout, CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_write_lock_for(timeout);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the timeout expires.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_read_lock_held_for(
+        const ChronoType& timeout, CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_read_lock_for(timeout);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_write_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_write_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_read_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_read_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
 };
 
 /**
  * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
- * the TimedMutex concept.
+ * upgradeable locking, in addition to the SharedMutex concept.
  */
 template <typename DerivedType, typename DataType>
-class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique_and_timed>
+class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::upgrade>
+    : public mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::shared>
 {
   public:
-    using timed_lock_proxy = lock_proxy<DerivedType, detail::timed_unique_lock_policy>;
+    using typename mutex_guarded_impl<
+        DerivedType, DataType, detail::mutex_category::shared>::unique_lock_proxy;
 
-    using const_timed_lock_proxy =
-        const lock_proxy<const DerivedType, detail::timed_unique_lock_policy>;
+    using upgrade_lock_proxy = lock_proxy<DerivedType, detail::upgrade_lock_policy>;
+
+  private:
+    /**
+     * @brief The callable that `with_upgradeable_lock_held(...)` passes to its functor. Upgrading
+     * more than once is harmless; every call returns the same data.
+     */
+    class upgrader
+    {
+      public:
+        upgrader(upgrade_lock_proxy& guard, std::optional<unique_lock_proxy>& upgraded)
+            : m_guard{ guard }, m_upgraded{ upgraded }
+        {
+        }
+
+        auto operator()() const -> DataType&
+        {
+            if (!m_upgraded) {
+                m_upgraded.emplace(detail::adopted_lock<DerivedType>{ m_guard.transition(
+                    [](auto& mutex) {
+                        mutex_traits<std::decay_t<decltype(mutex)>>::unlock_upgrade_and_lock(mutex);
+                    }) });
+            }
+
+            return **m_upgraded;
+        }
+
+      private:
+        upgrade_lock_proxy& m_guard;
+        std::optional<unique_lock_proxy>& m_upgraded;
+    };
+
+  public:
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an upgradeable
+     * lock on the underlying mutex. The proxy grants read-only access to the data, until it is
+     * upgraded to an exclusive lock through `upgrade()`.
+     *
+     * Only one thread can hold an upgradeable lock at a time, but it can do so alongside any number
+     * of readers.
+     *
+     * @returns An RAII proxy.
+     */
+    auto upgradeable_lock() -> upgrade_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this) };
+    }
+
+    /**
+     * @brief Grabs an upgradeable lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held. The functor is passed the data by const reference, along with a
+     * callable that upgrades the lock to an exclusive lock and returns a mutable reference to the
+     * data. The exclusive lock is held until the functor returns.
+     *
+     * This is useful for check-then-act sequences, such as filling in a cache entry on a miss,
+     * that would otherwise have to re-validate their check after trading a read lock for a write
+     * lock.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its first input parameter
+     *                                by const reference, and its second by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    [[nodiscard]] auto with_upgradeable_lock_held(CallableType&& callable) -> std::enable_if_t<
+        !std::is_same_v<
+            decltype(callable(std::declval<const DataType&>(), std::declval<upgrader>())), void>,
+        decltype(callable(std::declval<const DataType&>(), std::declval<upgrader>()))>
+    {
+        auto guard = upgradeable_lock();
+        std::optional<unique_lock_proxy> upgraded;
+
+        return callable(static_cast<DerivedType*>(this)->m_data, upgrader{ guard, upgraded });
+    }
+
+    /**
+     * @brief Grabs an upgradeable lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held. The functor is passed the data by const reference, along with a
+     * callable that upgrades the lock to an exclusive lock and returns a mutable reference to the
+     * data. The exclusive lock is held until the functor returns.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its first input parameter
+     *                                by const reference, and its second by value.
+     */
+    template <typename CallableType>
+    auto with_upgradeable_lock_held(CallableType&& callable) -> std::enable_if_t<
+        std::is_same_v<
+            decltype(callable(std::declval<const DataType&>(), std::declval<upgrader>())), void>,
+        void>
+    {
+        auto guard = upgradeable_lock();
+        std::optional<unique_lock_proxy> upgraded;
+
+        callable(static_cast<DerivedType*>(this)->m_data, upgrader{ guard, upgraded });
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an upgradeable lock
+     * on the underlying mutex, provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_upgradeable_lock() -> upgrade_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), std::try_to_lock };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an upgradeable lock
+     * on the underlying mutex, provided that the lock can be acquired before the timeout expires.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename ChronoType>
+    auto try_upgradeable_lock_for(const ChronoType& timeout) -> upgrade_lock_proxy
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an upgradeable lock
+     * on the underlying mutex, provided that the lock can be acquired before the deadline
+     * passes.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    template <typename TimePointType>
+    auto try_upgradeable_lock_until(const TimePointType& deadline) -> upgrade_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), deadline };
+    }
+};
 
+/**
+ * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
+ * the SharedTimedMutex concept.
+ */
+template <typename DerivedType, typename DataType>
+class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::shared_and_timed>
+{
+  public:
     using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
 
-    using const_unique_lock_proxy = const lock_proxy<const DerivedType, detail::unique_lock_policy>;
+    using shared_lock_proxy = const lock_proxy<const DerivedType, detail::shared_lock_policy>;
+
+    using timed_unique_lock_proxy = lock_proxy<DerivedType, detail::timed_unique_lock_policy>;
+
+    using timed_shared_lock_proxy =
+        const lock_proxy<const DerivedType, detail::timed_shared_lock_policy>;
 
     /**
-     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
+     * @brief Returns a proxy class that will manage the acquisition and release of an exclusive
+     * lock on the underlying mutex.
      *
      * @returns An RAII proxy.
      */
-    auto lock() -> unique_lock_proxy
+    auto write_lock() -> unique_lock_proxy
     {
         return { static_cast<DerivedType*>(this) };
     }
 
     /**
-     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex.
+     * @brief Returns a proxy class that will manage the acquisition and release of a shared
+     * lock on the underlying mutex.
      *
      * @returns An RAII proxy.
      */
-    auto lock() const -> const_unique_lock_proxy
+    auto read_lock() const -> shared_lock_proxy
     {
         return { static_cast<const DerivedType*>(this) };
     }
 
     /**
-     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex
-     * using the specified timeout.
+     * @brief Returns a proxy class that will manage the acquisition and release of an exclusive
+     * lock on the underlying mutex.
+     *
+     * The validity of the resulting proxy should be checked to see if the lock was acquired
+     * before the timer expired.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
      *
      * @returns An RAII proxy.
      */
-    template <typename ChronoType> auto try_lock_for(const ChronoType& timeout) -> timed_lock_proxy
+    template <typename ChronoType>
+    auto try_write_lock_for(const ChronoType& timeout) -> timed_unique_lock_proxy
     {
         return { static_cast<DerivedType*>(this), timeout };
     }
 
     /**
-     * @brief Returns a proxy class that will automatically lock and unlock the underlying mutex
-     * using the specified timeout.
+     * @brief Returns a proxy class that will manage the acquisition and release of a shared
+     * lock on the underlying mutex.
+     *
+     * The validity of the resulting proxy should be checked to see if the lock was acquired
+     * before the timer expired.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
      *
      * @returns An RAII proxy.
      */
     template <typename ChronoType>
-    auto try_lock_for(const ChronoType& timeout) const -> const_timed_lock_proxy
+    auto try_read_lock_for(const ChronoType& timeout) const -> timed_shared_lock_proxy
     {
         return { static_cast<const DerivedType*>(this), timeout };
     }
@@ -575,11 +2384,12 @@ class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique_a
      * @returns True if a lock was acquired on the mutex; false otherwise.
      */
     template <typename ChronoType, typename CallableType>
-    [[nodiscard]] auto try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable)
+    [[nodiscard]] auto
+    try_with_write_lock_held_for(const ChronoType& timeout, CallableType&& callable)
         -> std::enable_if_t<
             std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, bool>
     {
-        const auto guard = try_lock_for(timeout);
+        const auto guard = try_write_lock_for(timeout);
         if (guard.is_locked()) {
             callable(static_cast<DerivedType*>(this)->m_data);
             return true;
@@ -603,12 +2413,13 @@ class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique_a
      * instead.
      */
     template <typename ChronoType, typename CallableType>
-    [[nodiscard]] auto try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable)
+    [[nodiscard]] auto
+    try_with_write_lock_held_for(const ChronoType& timeout, CallableType&& callable)
         -> std::enable_if_t<
             !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
             std::optional<decltype(callable(std::declval<DataType&>()))>>
     {
-        const auto guard = try_lock_for(timeout);
+        const auto guard = try_write_lock_for(timeout);
         if (guard.is_locked()) {
             return callable(static_cast<DerivedType*>(this)->m_data);
         }
@@ -630,11 +2441,11 @@ class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique_a
      */
     template <typename ChronoType, typename CallableType>
     [[nodiscard]] auto
-    try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
+    try_with_read_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
         -> std::enable_if_t<
-            std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, bool>
+            std::is_same_v<decltype(callable(std::declval<const DataType&>())), void>, bool>
     {
-        const auto guard = try_lock_for(timeout);
+        const auto guard = try_read_lock_for(timeout);
         if (guard.is_locked()) {
             callable(static_cast<const DerivedType*>(this)->m_data);
             return true;
@@ -659,379 +2470,782 @@ class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::unique_a
      */
     template <typename ChronoType, typename CallableType>
     [[nodiscard]] auto
-    try_with_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
+    try_with_read_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
         -> std::enable_if_t<
-            !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
-            std::optional<decltype(callable(std::declval<DataType&>()))>>
+            !std::is_same_v<decltype(callable(std::declval<const DataType&>())), void>,
+            std::optional<decltype(callable(std::declval<const DataType&>()))>>
     {
-        const auto guard = try_lock_for(timeout);
+        const auto guard = try_read_lock_for(timeout);
         if (guard.is_locked()) {
             return callable(static_cast<const DerivedType*>(this)->m_data);
         }
 
         return {};
     }
-};
 
-/**
- * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
- * the SharedMutex concept.
- */
-template <typename DerivedType, typename DataType>
-class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::shared>
-{
-  public:
-    using shared_lock_proxy = const lock_proxy<const DerivedType, detail::shared_lock_policy>;
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release an exclusive lock on
+     * the underlying mutex, provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_write_lock() -> unique_lock_proxy
+    {
+        return { static_cast<DerivedType*>(this), std::try_to_lock };
+    }
 
-    using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
+    /**
+     * @brief Returns a proxy class that will automatically acquire and release a shared lock on the
+     * underlying mutex, provided that the lock can be acquired without blocking.
+     *
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
+     */
+    auto try_read_lock() const -> shared_lock_proxy
+    {
+        return { static_cast<const DerivedType*>(this), std::try_to_lock };
+    }
 
     /**
-     * @brief Returns a proxy class that will automatically acquire and release an exclusive
-     * lock on the underlying mutex.
+     * @brief Returns a proxy class that will automatically acquire and release an exclusive lock on
+     * the underlying mutex, provided that the lock can be acquired before the deadline passes.
      *
-     * @returns An RAII proxy.
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
      */
-    auto write_lock() -> unique_lock_proxy
+    template <typename TimePointType>
+    auto try_write_lock_until(const TimePointType& deadline) -> unique_lock_proxy
     {
-        return { static_cast<DerivedType*>(this) };
+        return { static_cast<DerivedType*>(this), deadline };
     }
 
     /**
-     * @brief Returns a proxy class that will automatically acquire and release a shared
-     * lock on the underlying mutex.
+     * @brief Returns a proxy class that will automatically acquire and release a shared lock on the
+     * underlying mutex, provided that the lock can be acquired before the deadline passes.
      *
-     * @returns An RAII proxy.
+     * @returns An RAII proxy, which only holds a lock if `is_locked()` returns true.
      */
-    auto read_lock() const -> shared_lock_proxy
+    template <typename TimePointType>
+    auto try_read_lock_until(const TimePointType& deadline) const -> shared_lock_proxy
     {
-        return { static_cast<const DerivedType*>(this) };
+        return { static_cast<const DerivedType*>(this), deadline };
     }
 
     /**
-     * @brief Grabs an exclusive lock on the underlying mutex, and then executes the passed in
-     * functor with the lock held.
+     * @brief Executes the functor only if the lock can be acquired without blocking.
      *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type must take its input parameter
-     *                                by reference; avoid taking input by value.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
      *
-     * @returns The result of invoking the functor.
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
      */
     template <typename CallableType>
-    [[nodiscard]] auto with_write_lock_held(CallableType&& callable) -> std::enable_if_t<
-        !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
-        decltype(callable(std::declval<DataType&>()))>
+    [[nodiscard]] auto try_with_write_lock_held(CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
     {
-        const auto guard = write_lock();
-        return callable(static_cast<DerivedType*>(this)->m_data);
+        auto guard = try_write_lock();
+        return detail::invoke_if_locked(guard, callable);
     }
 
     /**
-     * @brief Grabs an exclusive lock on the underlying mutex, and then executes the passed in
-     * functor with the lock held.
+     * @brief Executes the functor only if the lock can be acquired without blocking.
      *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type must take its input parameter
-     *                                by reference; avoid taking input by value.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
      */
     template <typename CallableType>
-    auto with_write_lock_held(CallableType&& callable) -> std::enable_if_t<
-        std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
+    [[nodiscard]] auto try_with_read_lock_held(CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
     {
-        const auto guard = write_lock();
-        callable(static_cast<DerivedType*>(this)->m_data);
+        auto guard = try_read_lock();
+        return detail::invoke_if_locked(guard, callable);
     }
 
     /**
-     * @brief Grabs a shared lock on the underlying mutex, and then executes the passed in
-     * functor with the lock held.
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
      *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type should take its input parameter
-     *                                by const reference. Failure to do so will result in
-     *                                compilation failure.
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_write_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable)
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, DataType&>>
+    {
+        auto guard = try_write_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if the lock can be acquired before the deadline passes.
+     *
+     * @param[in] deadline            The point in time at which to abandon the lock attempt.
+     * @param[in] callable            The functor to be invoked once the underlying mutex has
+     *                                been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename TimePointType, typename CallableType>
+    [[nodiscard]] auto try_with_read_lock_held_until(
+        const TimePointType& deadline, CallableType&& callable) const
+        -> detail::try_result_t<std::invoke_result_t<CallableType&, const DataType&>>
+    {
+        auto guard = try_read_lock_until(deadline);
+        return detail::invoke_if_locked(guard, callable);
+    }
+};
+} // namespace detail
+
+/**
+ * @brief A layout policy that stores the mutex and the data back-to-back, without any padding.
+ *
+ * This is the default, and it yields the smallest possible footprint.
+ */
+struct compact_layout
+{
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t mutex_alignment = alignof(MutexType);
+
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t data_alignment = alignof(DataType);
+};
+
+/**
+ * @brief A layout policy that aligns the entire object to a cache line, such that neighbouring
+ * objects (in an array, for instance) never share a cache line. The mutex and the data still share
+ * the first cache line.
+ */
+struct padded_layout
+{
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t mutex_alignment =
+        std::max(alignof(MutexType), detail::cache_line_size);
+
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t data_alignment = alignof(DataType);
+};
+
+/**
+ * @brief A layout policy that aligns the entire object to a cache line, and that also places the
+ * mutex and the data on separate cache lines, so that threads waiting on the mutex don't contend
+ * with the thread that is modifying the data.
+ */
+struct split_layout
+{
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t mutex_alignment =
+        std::max(alignof(MutexType), detail::cache_line_size);
+
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t data_alignment =
+        std::max(alignof(DataType), detail::cache_line_size);
+};
+
+/**
+ * @brief A layout policy that selects the `padded_layout` if the mutex and the data fit into a
+ * single cache line, and the `split_layout` otherwise.
+ */
+struct adaptive_layout
+{
+    template <typename MutexType, typename DataType>
+    static constexpr bool fits_in_cache_line =
+        sizeof(MutexType) + sizeof(DataType) <= detail::cache_line_size;
+
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t mutex_alignment =
+        padded_layout::mutex_alignment<MutexType, DataType>;
+
+    template <typename MutexType, typename DataType>
+    static constexpr std::size_t data_alignment =
+        fits_in_cache_line<MutexType, DataType>
+            ? padded_layout::data_alignment<MutexType, DataType>
+            : split_layout::data_alignment<MutexType, DataType>;
+};
+
+template <typename GuardType, typename FunctionType> class cached_view;
+
+namespace detail
+{
+template <typename GuardType, typename LockPolicyType> class guard_lockable;
+
+/**
+ * @brief The locking policy that `lock_all(...)` applies to a guard: guards that are passed in as
+ * const are locked in shared mode if their mutex supports it; all others are locked exclusively.
+ */
+template <typename GuardType> struct lock_all_policy
+{
+    using category_type =
+        typename mutex_traits<typename GuardType::mutex_type>::category_type;
+
+    static constexpr bool is_shared =
+        std::is_const_v<GuardType> &&
+        (std::is_same_v<category_type, mutex_category::shared> ||
+         std::is_same_v<category_type, mutex_category::shared_and_timed> ||
+         std::is_same_v<category_type, mutex_category::upgrade>);
+
+    using type = std::conditional_t<is_shared, shared_lock_policy, unique_lock_policy>;
+};
+
+template <typename GuardType>
+using lock_all_proxy = lock_proxy<GuardType, typename lock_all_policy<GuardType>::type>;
+
+/**
+ * @brief Wraps the awaitable of an asynchronous mutex, such that awaiting it yields a
+ * `lock_proxy<...>` that adopts the lock.
+ */
+template <typename BaseType, typename LockPolicyType, typename AwaiterType> class proxy_awaiter
+{
+  public:
+    proxy_awaiter(BaseType* base, AwaiterType awaiter)
+        : m_base{ base }, m_awaiter{ std::move(awaiter) }
+    {
+    }
+
+    auto await_ready() -> bool
+    {
+        return m_awaiter.await_ready();
+    }
+
+    template <typename CoroutineHandleType> auto await_suspend(CoroutineHandleType coroutine)
+    {
+        return m_awaiter.await_suspend(coroutine);
+    }
+
+    auto await_resume() -> lock_proxy<BaseType, LockPolicyType>
+    {
+        m_awaiter.await_resume();
+        return adopted_lock<BaseType>{ m_base };
+    }
+
+  private:
+    BaseType* m_base;
+    AwaiterType m_awaiter;
+};
+
+template <
+    typename DataType, typename MutexType, typename LayoutPolicy, typename StatisticsPolicy,
+    typename NotificationPolicy, typename VersioningPolicy>
+using mutex_guarded_base = detail::mutex_guarded_impl<
+    mutex_guarded<
+        DataType, MutexType, LayoutPolicy, StatisticsPolicy, NotificationPolicy, VersioningPolicy>,
+    DataType, typename detail::mutex_traits<MutexType>::category_type>;
+}
+
+/**
+ * @brief A light-weight wrapper that ensures that all reads and writes from and to the supplied
+ * data type are guarded by a mutex.
+ *
+ * This class uses the Curiously Recurring Template Pattern (CRTP) and template metaprogramming to
+ * statically inherit functionality appropriate to the specified mutex. See the various
+ * `detail::mutex_guard_impl<...>` classes for further documentation.
+ *
+ * The `LayoutPolicy` controls how the mutex and the data are laid out in memory; see
+ * `compact_layout`, `padded_layout`, `split_layout`, and `adaptive_layout`.
+ *
+ * The `StatisticsPolicy` controls whether lock acquisitions are instrumented; see `no_statistics`
+ * and `lock_statistics`.
+ *
+ * The `NotificationPolicy` controls whether threads can wait for the data to change; see
+ * `no_notification` and `condition_notification`.
+ *
+ * The `VersioningPolicy` controls whether the guard counts the releases of write locks, which
+ * tells readers whether the data may have changed; see `no_versioning` and `write_versioning`.
+ */
+template <
+    typename DataType, typename MutexType = std::mutex, typename LayoutPolicy = compact_layout,
+    typename StatisticsPolicy = no_statistics, typename NotificationPolicy = no_notification,
+    typename VersioningPolicy = no_versioning>
+class mutex_guarded
+    : public detail::mutex_guarded_base<
+          DataType, MutexType, LayoutPolicy, StatisticsPolicy, NotificationPolicy,
+          VersioningPolicy>,
+      public StatisticsPolicy::storage,
+      public NotificationPolicy::template storage<MutexType>,
+      public VersioningPolicy::storage
+{
+    static_assert(
+        detail::traits::is_mutex<MutexType>::value, "The MutexType must support the Mutex concept");
+
+    template <typename P, typename L> friend class lock_proxy;
+
+    template <typename S, typename D, typename T> friend class detail::mutex_guarded_impl;
+
+    template <typename G, typename L> friend class detail::guard_lockable;
+
+  public:
+    using value_type = DataType;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using mutex_type = MutexType;
+    using layout_policy = LayoutPolicy;
+    using statistics_policy = StatisticsPolicy;
+    using notification_policy = NotificationPolicy;
+    using versioning_policy = VersioningPolicy;
+
+    mutex_guarded() = default;
+    ~mutex_guarded() noexcept = default;
+
+    mutex_guarded(DataType data) : m_data{ std::move(data) }
+    {
+    }
+
+    mutex_guarded(const mutex_guarded& other)
+    {
+        const std::lock_guard<MutexType> guard{ other.m_mutex };
+        m_data = other.m_data;
+    }
+
+    mutex_guarded& operator=(const mutex_guarded& other)
+    {
+        if (this != &other) {
+            auto [mine, theirs] = lock_all(*this, std::as_const(other));
+            *mine = *theirs;
+        }
+
+        return *this;
+    }
+
+    mutex_guarded(mutex_guarded&& other) : m_data{ std::move(other.m_data) }
+    {
+    }
+
+    mutex_guarded& operator=(mutex_guarded&& other)
+    {
+        if (this != &other) {
+            auto [mine, theirs] = lock_all(*this, other);
+            *mine = std::move(*theirs);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Constructs the data in place, from the passed in arguments, so that data types that
+     * are expensive or impossible to move don't have to be moved into the guard.
+     */
+    template <typename... ArgumentTypes>
+    explicit mutex_guarded(std::in_place_t, ArgumentTypes&&... arguments)
+        : m_data(std::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    /**
+     * @brief Replaces the data with the passed in value. Only the swap happens under an exclusive
+     * lock; the old value is handed back to the caller after the lock has been released, so that
+     * destroying it, which may free large amounts of memory, doesn't stall other threads.
      *
-     * @returns The result of invoking the functor.
+     * @param[in] value               The new value, which is best constructed before the call.
+     *
+     * @returns The old value.
      */
-    template <typename CallableType>
-    [[nodiscard]] auto with_read_lock_held(CallableType&& callable) const -> std::enable_if_t<
-        !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
-        decltype(callable(std::declval<DataType&>()))>
+    auto exchange(DataType value) -> DataType
     {
-        const auto guard = read_lock();
-        return callable(static_cast<const DerivedType*>(this)->m_data);
+        {
+            const lock_proxy<mutex_guarded, detail::unique_lock_policy> guard{ this };
+
+            using std::swap;
+            swap(m_data, value);
+        }
+
+        return value;
     }
 
     /**
-     * @brief Grabs a shared lock on the underlying mutex, and then executes the passed in
-     * functor with the lock held.
+     * @brief Moves the data out of the guard, leaving a default-constructed value behind. As with
+     * `exchange(...)`, the replacement is constructed before the lock is acquired.
      *
-     * @param[in] callable            A callable type like a lambda, std::function, etc.
-     *                                This callable type should take its input parameter
-     *                                by const reference. Failure to do so will result in
-     *                                compilation failure.
+     * @returns The old value.
      */
-    template <typename CallableType>
-    auto with_read_lock_held(CallableType&& callable) const -> std::enable_if_t<
-        std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, void>
+    template <
+        typename D = DataType, typename = std::enable_if_t<std::is_default_constructible_v<D>>>
+    auto take() -> DataType
     {
-        const auto guard = read_lock();
-        callable(static_cast<const DerivedType*>(this)->m_data);
+        return exchange(DataType{});
     }
-};
-
-/**
- * @brief Specialization that provides the functionality to lock and unlock a mutex that supports
- * the SharedTimedMutex concept.
- */
-template <typename DerivedType, typename DataType>
-class mutex_guarded_impl<DerivedType, DataType, detail::mutex_category::shared_and_timed>
-{
-  public:
-    using unique_lock_proxy = lock_proxy<DerivedType, detail::unique_lock_policy>;
 
-    using shared_lock_proxy = const lock_proxy<const DerivedType, detail::shared_lock_policy>;
+    /**
+     * @brief Swaps the data of two guards, which are locked at once, as per `lock_all(...)`, so
+     * that two threads that swap the same guards in opposite order can't deadlock.
+     */
+    void swap(mutex_guarded& other)
+    {
+        if (this == &other) {
+            return;
+        }
 
-    using timed_unique_lock_proxy = lock_proxy<DerivedType, detail::timed_unique_lock_policy>;
+        auto [mine, theirs] = lock_all(*this, other);
 
-    using timed_shared_lock_proxy =
-        const lock_proxy<const DerivedType, detail::timed_shared_lock_policy>;
+        using std::swap;
+        swap(*mine, *theirs);
+    }
 
     /**
-     * @brief Returns a proxy class that will manage the acquisition and release of an exclusive
-     * lock on the underlying mutex.
+     * @brief Copy-assigns the data to the passed in object, under a shared lock if the mutex
+     * supports it. Unlike taking a copy through a proxy, this reuses the storage that the object
+     * has already allocated, such as the capacity of a vector, across repeated snapshots.
      *
-     * @returns An RAII proxy.
+     * @param[out] destination        The object to copy the data into.
      */
-    auto write_lock() -> unique_lock_proxy
+    void copy_into(DataType& destination) const
     {
-        return { static_cast<DerivedType*>(this) };
+        const detail::lock_all_proxy<const mutex_guarded> guard{ this };
+        destination = m_data;
     }
 
     /**
-     * @brief Returns a proxy class that will manage the acquisition and release of a shared
-     * lock on the underlying mutex.
+     * @brief Updates the data without holding the lock during an expensive computation. The data
+     * is copied under a brief shared lock, if the mutex supports one, and the computation runs on
+     * that snapshot with no lock held. The result is then committed under an exclusive lock,
+     * provided that no write lock was released in the meantime; otherwise, the whole process is
+     * retried, up to the given number of attempts. Only available if the guard keeps a write
+     * version (see `write_versioning`).
      *
-     * @returns An RAII proxy.
+     * @param[in] compute             A callable that takes the snapshot by const reference, and
+     *                                returns the result to commit.
+     * @param[in] commit              A callable that takes the data by reference, and the result
+     *                                of `compute` as an rvalue, and applies the result to the data.
+     * @param[in] max_attempts        The number of times to compute the result before giving up.
+     *
+     * @returns True if the result was committed, or false if every attempt was invalidated by a
+     * concurrent write, in which case the caller may fall back on `with_lock_held(...)`.
      */
-    auto read_lock() const -> shared_lock_proxy
+    template <
+        typename ComputeType, typename CommitType, typename PolicyType = VersioningPolicy,
+        typename = std::enable_if_t<PolicyType::is_enabled>>
+    auto update_optimistically(
+        ComputeType&& compute, CommitType&& commit, std::size_t max_attempts = 4) -> bool
     {
-        return { static_cast<const DerivedType*>(this) };
+        using result_type = std::invoke_result_t<ComputeType&, const DataType&>;
+        static_assert(
+            !std::is_void_v<result_type>,
+            "The compute step must return the result that the commit step applies.");
+
+        std::optional<DataType> snapshot;
+
+        for (std::size_t attempt = 0; attempt < max_attempts; ++attempt) {
+            std::uint64_t version = 0;
+
+            {
+                const detail::lock_all_proxy<const mutex_guarded> guard{ this };
+
+                // Later attempts reuse the storage of the previous snapshot.
+                if (snapshot) {
+                    *snapshot = m_data;
+                } else {
+                    snapshot.emplace(m_data);
+                }
+
+                version = this->version();
+            }
+
+            auto result = compute(std::as_const(*snapshot));
+
+            lock_proxy<mutex_guarded, detail::unique_lock_policy> guard{ this };
+            if (this->version() == version) {
+                commit(m_data, std::move(result));
+                return true;
+            }
+
+            // Nothing was committed, so this attempt mustn't invalidate other updaters, cached
+            // views, or notify the subscribers.
+            guard.unlock_unmodified();
+        }
+
+        return false;
     }
 
     /**
-     * @brief Returns a proxy class that will manage the acquisition and release of an exclusive
-     * lock on the underlying mutex.
+     * @brief Creates a view that memoizes a value derived from the data, such as a sorted copy or
+     * an aggregate. The view only recomputes the value once a write lock has been released since
+     * it was last computed; until then, it hands out the cached value without locking the data.
+     * Only available if the guard keeps a write version (see `write_versioning`).
      *
-     * The validity of the resulting proxy should be checked to see if the lock was acquired
-     * before the timer expired.
-     *
-     * @param[in] timeout             The length of time to wait before abandoning the lock
-     *                                attempt.
+     * @param[in] function            A callable that takes the data by const reference, and returns
+     *                                the derived value. It's invoked with a shared lock held, if
+     *                                the mutex supports one.
      *
-     * @returns An RAII proxy.
+     * @returns The view, which must not outlive the guard.
      */
-    template <typename ChronoType>
-    auto try_write_lock_for(const ChronoType& timeout) -> timed_unique_lock_proxy
+    template <
+        typename FunctionType, typename PolicyType = VersioningPolicy,
+        typename = std::enable_if_t<PolicyType::is_enabled>>
+    auto derived(FunctionType&& function) const
+        -> cached_view<mutex_guarded, std::decay_t<FunctionType>>
     {
-        return { static_cast<DerivedType*>(this), timeout };
+        return cached_view<mutex_guarded, std::decay_t<FunctionType>>{
+            this, std::forward<FunctionType>(function)
+        };
     }
 
     /**
-     * @brief Returns a proxy class that will manage the acquisition and release of a shared
-     * lock on the underlying mutex.
-     *
-     * The validity of the resulting proxy should be checked to see if the lock was acquired
-     * before the timer expired.
+     * @brief Grabs an exclusive lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held. If the functor reports that it modified the data, one of the
+     * threads that are waiting on the data is woken up after the lock has been released.
      *
-     * @param[in] timeout             The length of time to wait before abandoning the lock
-     *                                attempt.
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference, and return true if it modified the data.
      *
-     * @returns An RAII proxy.
+     * @returns The result of invoking the functor.
      */
-    template <typename ChronoType>
-    auto try_read_lock_for(const ChronoType& timeout) const -> timed_shared_lock_proxy
+    template <
+        typename CallableType, typename PolicyType = NotificationPolicy,
+        typename = std::enable_if_t<PolicyType::is_enabled>>
+    auto modify_and_notify_one(CallableType&& callable) -> bool
     {
-        return { static_cast<const DerivedType*>(this), timeout };
+        const auto was_modified = modify(callable);
+        if (was_modified) {
+            this->notify_one();
+        }
+
+        return was_modified;
     }
 
     /**
-     * @brief Executes the functor only if the mutex can be locked before the timer expires.
-     *
-     * This function will be enabled if the functor's return type is void.
+     * @brief Grabs an exclusive lock on the underlying mutex, and then executes the passed in
+     * functor with the lock held. If the functor reports that it modified the data, all threads
+     * that are waiting on the data are woken up after the lock has been released.
      *
-     * @param[in] timeout             The length of time to wait before abandoning the lock
-     *                                attempt.
-     * @param[in] callable            The functor to be invoked once the underlying mutex has
-     *                                been locked.
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference, and return true if it modified the data.
      *
-     * @returns True if a lock was acquired on the mutex; false otherwise.
+     * @returns The result of invoking the functor.
      */
-    template <typename ChronoType, typename CallableType>
-    [[nodiscard]] auto
-    try_with_write_lock_held_for(const ChronoType& timeout, CallableType&& callable)
-        -> std::enable_if_t<
-            std::is_same_v<decltype(callable(std::declval<DataType&>())), void>, bool>
+    template <
+        typename CallableType, typename PolicyType = NotificationPolicy,
+        typename = std::enable_if_t<PolicyType::is_enabled>>
+    auto modify_and_notify_all(CallableType&& callable) -> bool
     {
-        const auto guard = try_write_lock_for(timeout);
-        if (guard.is_locked()) {
-            callable(static_cast<DerivedType*>(this)->m_data);
-            return true;
+        const auto was_modified = modify(callable);
+        if (was_modified) {
+            this->notify_all();
         }
 
-        return false;
+        return was_modified;
     }
 
     /**
-     * @brief Executes the functor only if the mutex can be locked before the timer expires.
-     *
-     * This function will be enabled if the functor's return type is not void.
+     * @brief Acquires an exclusive lock without blocking the calling thread. Only available if the
+     * mutex supports asynchronous locking, such as an `async_mutex` (see async_mutex.h).
      *
-     * @param[in] timeout             The length of time to wait before abandoning the lock
-     *                                attempt.
-     * @param[in] callable            The functor to be invoked once the underlying mutex has
-     *                                been locked.
+     * @param[in] executor            Optionally, the executor through which the awaiting coroutine
+     *                                is resumed if it has to wait for the lock.
      *
-     * @returns An optional containing the result of invoking the functor if a lock on the
-     * mutex was obtained. If the lock could not be obtained, an empty optional is returned
-     * instead.
+     * @returns An awaitable that suspends the coroutine until the lock has been acquired, and that
+     * then yields an RAII proxy.
      */
-    template <typename ChronoType, typename CallableType>
-    [[nodiscard]] auto
-    try_with_write_lock_held_for(const ChronoType& timeout, CallableType&& callable)
-        -> std::enable_if_t<
-            !std::is_same_v<decltype(callable(std::declval<DataType&>())), void>,
-            std::optional<decltype(callable(std::declval<DataType&>()))>>
+    template <
+        typename... ExecutorTypes, typename M = MutexType,
+        typename = std::enable_if_t<
+            detail::traits::is_async_mutex<M>::value &&
+            !detail::traits::is_shared_mutex<M>::value>>
+    auto async_lock(ExecutorTypes... executor)
     {
-        const auto guard = try_write_lock_for(timeout);
-        if (guard.is_locked()) {
-            return callable(static_cast<DerivedType*>(this)->m_data);
-        }
+        using awaiter_type = decltype(m_mutex.async_lock(std::move(executor)...));
+        using proxy_awaiter_type =
+            detail::proxy_awaiter<mutex_guarded, detail::unique_lock_policy, awaiter_type>;
 
-        return {};
+        return proxy_awaiter_type{ this, m_mutex.async_lock(std::move(executor)...) };
     }
 
     /**
-     * @brief Executes the functor only if the mutex can be locked before the timer expires.
-     *
-     * This function will be enabled if the functor's return type is void.
+     * @brief Acquires an exclusive lock without blocking the calling thread. Only available if the
+     * mutex supports asynchronous shared locking, such as an `async_shared_mutex` (see
+     * async_mutex.h).
      *
-     * @param[in] timeout             The length of time to wait before abandoning the lock
-     *                                attempt.
-     * @param[in] callable            The functor to be invoked once the underlying mutex has
-     *                                been locked.
+     * @param[in] executor            Optionally, the executor through which the awaiting coroutine
+     *                                is resumed if it has to wait for the lock.
      *
-     * @returns True if a lock was acquired on the mutex; false otherwise.
+     * @returns An awaitable that suspends the coroutine until the lock has been acquired, and that
+     * then yields an RAII proxy.
      */
-    template <typename ChronoType, typename CallableType>
-    [[nodiscard]] auto
-    try_with_read_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
-        -> std::enable_if_t<
-            std::is_same_v<decltype(callable(std::declval<const DataType&>())), void>, bool>
+    template <
+        typename... ExecutorTypes, typename M = MutexType,
+        typename = std::enable_if_t<detail::traits::is_async_shared_mutex<M>::value>>
+    auto async_write_lock(ExecutorTypes... executor)
     {
-        const auto guard = try_write_lock_for(timeout);
-        if (guard.is_locked()) {
-            callable(static_cast<const DerivedType*>(this)->m_data);
-            return true;
-        }
+        using awaiter_type = decltype(m_mutex.async_lock(std::move(executor)...));
+        using proxy_awaiter_type =
+            detail::proxy_awaiter<mutex_guarded, detail::unique_lock_policy, awaiter_type>;
 
-        return false;
+        return proxy_awaiter_type{ this, m_mutex.async_lock(std::move(executor)...) };
     }
 
     /**
-     * @brief Executes the functor only if the mutex can be locked before the timer expires.
-     *
-     * This function will be enabled if the functor's return type is not void.
+     * @brief Acquires a shared lock without blocking the calling thread. Only available if the
+     * mutex supports asynchronous shared locking, such as an `async_shared_mutex` (see
+     * async_mutex.h).
      *
-     * @param[in] timeout             The length of time to wait before abandoning the lock
-     *                                attempt.
-     * @param[in] callable            The functor to be invoked once the underlying mutex has
-     *                                been locked.
+     * @param[in] executor            Optionally, the executor through which the awaiting coroutine
+     *                                is resumed if it has to wait for the lock.
      *
-     * @returns An optional containing the result of invoking the functor if a lock on the
-     * mutex was obtained. If the lock could not be obtained, an empty optional is returned
-     * instead.
+     * @returns An awaitable that suspends the coroutine until the lock has been acquired, and that
+     * then yields an RAII proxy that grants read-only access.
      */
-    template <typename ChronoType, typename CallableType>
-    [[nodiscard]] auto
-    try_with_read_lock_held_for(const ChronoType& timeout, CallableType&& callable) const
-        -> std::enable_if_t<
-            !std::is_same_v<decltype(callable(std::declval<const DataType&>())), void>,
-            std::optional<decltype(callable(std::declval<const DataType&>()))>>
+    template <
+        typename... ExecutorTypes, typename M = MutexType,
+        typename = std::enable_if_t<detail::traits::is_async_shared_mutex<M>::value>>
+    auto async_read_lock(ExecutorTypes... executor) const
     {
-        const auto guard = try_read_lock_for(timeout);
-        if (guard.is_locked()) {
-            return callable(static_cast<const DerivedType*>(this)->m_data);
-        }
+        using awaiter_type = decltype(m_mutex.async_lock_shared(std::move(executor)...));
+        using proxy_awaiter_type = detail::proxy_awaiter<
+            const mutex_guarded, detail::shared_lock_policy, awaiter_type>;
 
-        return {};
+        return proxy_awaiter_type{ this, m_mutex.async_lock_shared(std::move(executor)...) };
     }
-};
-} // namespace detail
 
-template <typename DataType, typename MutexType> class mutex_guarded;
+  private:
+    template <typename CallableType> auto modify(CallableType& callable) -> bool
+    {
+        const lock_proxy<mutex_guarded, detail::unique_lock_policy> guard{ this };
+        return callable(m_data);
+    }
 
-namespace detail
+    alignas(LayoutPolicy::template mutex_alignment<MutexType, DataType>) mutable MutexType m_mutex;
+    alignas(LayoutPolicy::template data_alignment<MutexType, DataType>) DataType m_data;
+};
+
+/**
+ * @brief Swaps the data of two guards; see `mutex_guarded<...>::swap(...)`.
+ */
+template <
+    typename DataType, typename MutexType, typename LayoutPolicy, typename StatisticsPolicy,
+    typename NotificationPolicy, typename VersioningPolicy>
+void swap(
+    mutex_guarded<
+        DataType, MutexType, LayoutPolicy, StatisticsPolicy, NotificationPolicy, VersioningPolicy>&
+        lhs,
+    mutex_guarded<
+        DataType, MutexType, LayoutPolicy, StatisticsPolicy, NotificationPolicy, VersioningPolicy>&
+        rhs)
 {
-template <typename DataType, typename MutexType>
-using mutex_guarded_base = detail::mutex_guarded_impl<
-    mutex_guarded<DataType, MutexType>, DataType,
-    typename detail::mutex_traits<MutexType>::category_type>;
+    lhs.swap(rhs);
 }
 
 /**
- * @brief A light-weight wrapper that ensures that all reads and writes from and to the supplied
- * data type are guarded by a mutex.
- *
- * This class uses the Curiously Recurring Template Pattern (CRTP) and template metaprogramming to
- * statically inherit functionality appropriate to the specified mutex. See the various
- * `detail::mutex_guard_impl<...>` classes for further documentation.
+ * @brief A `mutex_guarded<...>` that occupies its own cache line(s), making it suitable for use in
+ * arrays of per-thread state.
  */
 template <typename DataType, typename MutexType = std::mutex>
-class mutex_guarded : public detail::mutex_guarded_base<DataType, MutexType>
-{
-    static_assert(
-        detail::traits::is_mutex<MutexType>::value, "The MutexType must support the Mutex concept");
-
-    template <typename P, typename L> friend class lock_proxy;
-
-    template <typename S, typename D, typename T> friend class detail::mutex_guarded_impl;
+using padded_mutex_guarded = mutex_guarded<DataType, MutexType, adaptive_layout>;
 
+namespace detail
+{
+/**
+ * @brief Adapts a guard's mutex to the Lockable concept, using the given locking policy, so that
+ * it can be passed to `std::lock(...)`.
+ */
+template <typename GuardType, typename LockPolicyType> class guard_lockable
+{
   public:
-    using value_type = DataType;
-    using reference = value_type&;
-    using const_reference = const value_type&;
-    using mutex_type = MutexType;
-
-    mutex_guarded() = default;
-    ~mutex_guarded() noexcept = default;
-
-    mutex_guarded(DataType data) : m_data{ std::move(data) }
+    guard_lockable(GuardType& guard) : m_guard{ guard }
     {
     }
 
-    mutex_guarded(const mutex_guarded<DataType, MutexType>& other)
+    void lock()
     {
-        const std::lock_guard<MutexType> guard{ other.m_mutex };
-        m_data = other.m_data;
-    }
-
-    mutex_guarded<DataType, MutexType>& operator=(const mutex_guarded<DataType, MutexType>& other)
-    {
-        const std::lock_guard<MutexType> guard{ other.m_mutex };
-        m_data = other.m_data;
+        LockPolicyType::lock(m_guard.m_mutex);
     }
 
-    mutex_guarded(mutex_guarded<DataType, MutexType>&& other) : m_data{ std::move(other.m_data) }
+    [[nodiscard]] auto try_lock() -> bool
     {
+        return LockPolicyType::try_lock(m_guard.m_mutex);
     }
 
-    mutex_guarded<DataType, MutexType>& operator=(mutex_guarded<DataType, MutexType>&& other)
+    void unlock()
     {
-        m_data = std::move(other.m_data);
+        LockPolicyType::unlock(m_guard.m_mutex);
     }
 
   private:
-    mutable MutexType m_mutex;
-    DataType m_data;
+    GuardType& m_guard;
 };
+
+template <typename... GuardTypes> auto are_distinct(const GuardTypes&... guards) -> bool
+{
+    const void* const addresses[] = { static_cast<const void*>(&guards)... };
+
+    for (std::size_t lhs = 0; lhs < sizeof...(GuardTypes); ++lhs) {
+        for (std::size_t rhs = lhs + 1; rhs < sizeof...(GuardTypes); ++rhs) {
+            if (addresses[lhs] == addresses[rhs]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+} // namespace detail
+
+/**
+ * @brief Locks all of the passed in guards at once, without risking a deadlock against other
+ * threads that lock an overlapping set of guards in a different order.
+ *
+ * The locks are acquired using the same try-and-back-off algorithm as `std::lock(...)`. Guards that
+ * are passed in as const (for instance, through `std::as_const(...)`) are locked in shared mode if
+ * their mutex supports the SharedMutex concept; all other guards are locked exclusively.
+ *
+ * Usage:
+ *
+ *     auto [source, destination] = lock_all(first_queue, second_queue);
+ *     destination->push_back(source->front());
+ *     source->pop_front();
+ *
+ * @param[in] guards              The guards to lock. The same guard must not be passed in twice.
+ *
+ * @returns A tuple of RAII proxies, one per guard, in the order in which the guards were passed.
+ */
+template <typename... GuardTypes>
+[[nodiscard]] auto lock_all(GuardTypes&... guards)
+    -> std::tuple<detail::lock_all_proxy<GuardTypes>...>
+{
+    static_assert(sizeof...(GuardTypes) > 0, "At least one guard must be passed to lock_all(...).");
+
+    assert(detail::are_distinct(guards...));
+
+    if constexpr (sizeof...(GuardTypes) == 1) {
+        return { &guards... };
+    } else {
+        std::tuple<detail::guard_lockable<
+            GuardTypes, typename detail::lock_all_policy<GuardTypes>::type>...>
+            lockables{ guards... };
+
+        std::apply([](auto&... lockable) { std::lock(lockable...); }, lockables);
+
+        return { detail::adopted_lock<GuardTypes>{ &guards }... };
+    }
+}
+
+/**
+ * @brief Locks all of the passed in guards at once, as per `lock_all(...)`, and then executes the
+ * passed in functor with the locks held.
+ *
+ * @param[in] callable            A callable type like a lambda, std::function, etc. It is invoked
+ *                                with a reference to the data of each guard, in the order in
+ *                                which the guards were passed; guards that were passed in as
+ *                                const yield a const reference.
+ * @param[in] guards              The guards to lock. The same guard must not be passed in twice.
+ *
+ * @returns The result of invoking the functor, which must not be a reference, since the locks are
+ * released before the caller gets to use it.
+ */
+template <typename CallableType, typename... GuardTypes>
+auto with_all_locked(CallableType&& callable, GuardTypes&... guards)
+{
+    static_assert(
+        !std::is_reference_v<decltype(callable(
+            *std::declval<detail::lock_all_proxy<GuardTypes>&>()...))>,
+        "The result of the functor outlives the locks, so it can't be a reference.");
+
+    auto proxies = lock_all(guards...);
+
+    return std::apply([&](auto&... proxy) { return callable(*proxy...); }, proxies);
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "versioned_guarded.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace detail
+{
+/**
+ * @brief A single subscription to the changes of a guard. Notifications are coalesced: while the
+ * callback runs, later writes only raise the pending version, which is delivered once the callback
+ * returns, so a slow subscriber has at most one notification pending rather than a queue of them.
+ */
+class change_subscriber
+{
+  public:
+    explicit change_subscriber(std::function<void(std::uint64_t)> callback)
+        : m_callback{ std::move(callback) }
+    {
+    }
+
+    /**
+     * @brief Delivers the passed in version, unless a newer one has already been delivered. If
+     * another thread is delivering a notification to this subscriber at the moment, it picks up the
+     * new version once its callback returns, so that this thread doesn't have to wait.
+     */
+    void notify(std::uint64_t version) noexcept
+    {
+        auto pending = m_pending.load();
+        while (pending < version && !m_pending.compare_exchange_weak(pending, version)) {
+        }
+
+        // Whoever is delivering at the moment, possibly this very thread, if the callback wrote to
+        // the guard, rechecks the pending version after it's done, so there's no need to wait.
+        while (!m_is_delivering.exchange(true)) {
+            {
+                const std::lock_guard<std::mutex> guard{ m_delivery_mutex };
+                m_delivering_thread.store(std::this_thread::get_id());
+
+                for (auto latest = m_pending.load(); m_is_active.load() && m_delivered < latest;
+                     latest = m_pending.load()) {
+                    m_callback(latest);
+                    m_delivered.store(latest);
+                }
+
+                m_delivering_thread.store(std::thread::id{});
+            }
+
+            m_is_delivering.store(false);
+
+            if (!m_is_active.load() || m_delivered.load() >= m_pending.load()) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Stops further notifications, and waits for one that is being delivered on another
+     * thread to complete, such that the callback is guaranteed not to run once this returns.
+     */
+    void deactivate() noexcept
+    {
+        m_is_active.store(false);
+
+        if (m_delivering_thread.load() != std::this_thread::get_id()) {
+            const std::lock_guard<std::mutex> guard{ m_delivery_mutex };
+        }
+    }
+
+  private:
+    std::function<void(std::uint64_t)> m_callback;
+
+    std::atomic<std::uint64_t> m_pending{ 0 };
+    std::atomic<std::uint64_t> m_delivered{ 0 };
+    std::atomic<bool> m_is_active{ true };
+    std::atomic<bool> m_is_delivering{ false };
+
+    // Held while the callback runs, so that deactivating the subscriber can wait for it.
+    std::mutex m_delivery_mutex;
+    std::atomic<std::thread::id> m_delivering_thread{ std::thread::id{} };
+};
+
+/**
+ * @brief The subscribers of a guard. The list is copied on every change, so that notifying the
+ * subscribers only needs to briefly lock the list to take a reference to the current copy.
+ */
+class change_subscriber_list
+{
+  public:
+    using subscribers_type = std::vector<std::shared_ptr<change_subscriber>>;
+
+    void add(std::shared_ptr<change_subscriber> subscriber)
+    {
+        const std::lock_guard<std::mutex> guard{ m_mutex };
+
+        auto subscribers = std::make_shared<subscribers_type>(*m_subscribers);
+        subscribers->push_back(std::move(subscriber));
+
+        m_subscribers = std::move(subscribers);
+        m_has_subscribers.store(true, std::memory_order_release);
+    }
+
+    void remove(const change_subscriber* subscriber)
+    {
+        const std::lock_guard<std::mutex> guard{ m_mutex };
+
+        auto subscribers = std::make_shared<subscribers_type>(*m_subscribers);
+        subscribers->erase(
+            std::remove_if(
+                subscribers->begin(), subscribers->end(),
+                [&](const auto& candidate) { return candidate.get() == subscriber; }),
+            subscribers->end());
+
+        m_has_subscribers.store(!subscribers->empty(), std::memory_order_release);
+        m_subscribers = std::move(subscribers);
+    }
+
+    void notify(std::uint64_t version) noexcept
+    {
+        if (!m_has_subscribers.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::shared_ptr<const subscribers_type> subscribers;
+        {
+            const std::lock_guard<std::mutex> guard{ m_mutex };
+            subscribers = m_subscribers;
+        }
+
+        for (const auto& subscriber : *subscribers) {
+            subscriber->notify(version);
+        }
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::shared_ptr<const subscribers_type> m_subscribers = std::make_shared<subscribers_type>();
+    std::atomic<bool> m_has_subscribers{ false };
+};
+} // namespace detail
+
+/**
+ * @brief A handle to a callback that was registered through `subscribe(...)`. The callback is
+ * unregistered when the handle is destroyed, or when `unsubscribe()` is called, whichever comes
+ * first. The handle may outlive the guard that it was obtained from.
+ */
+class [[nodiscard]] change_subscription
+{
+  public:
+    change_subscription() = default;
+
+    change_subscription(
+        std::weak_ptr<detail::change_subscriber_list> list,
+        std::shared_ptr<detail::change_subscriber> subscriber) noexcept
+        : m_list{ std::move(list) }, m_subscriber{ std::move(subscriber) }
+    {
+    }
+
+    ~change_subscription() noexcept
+    {
+        unsubscribe();
+    }
+
+    change_subscription(change_subscription&& other) noexcept = default;
+
+    change_subscription& operator=(change_subscription&& other) noexcept
+    {
+        if (this != &other) {
+            unsubscribe();
+            m_list = std::move(other.m_list);
+            m_subscriber = std::move(other.m_subscriber);
+        }
+
+        return *this;
+    }
+
+    change_subscription(const change_subscription&) = delete;
+    change_subscription& operator=(const change_subscription&) = delete;
+
+    auto is_subscribed() const noexcept -> bool
+    {
+        return m_subscriber != nullptr;
+    }
+
+    /**
+     * @brief Unregisters the callback. Once this returns, the callback won't be invoked anymore,
+     * and it isn't running on any other thread. May be called from within the callback itself,
+     * but not while holding the guard's lock, if the callback locks the guard.
+     */
+    void unsubscribe() noexcept
+    {
+        if (m_subscriber == nullptr) {
+            return;
+        }
+
+        m_subscriber->deactivate();
+
+        if (const auto list = m_list.lock()) {
+            list->remove(m_subscriber.get());
+        }
+
+        m_list.reset();
+        m_subscriber.reset();
+    }
+
+  private:
+    std::weak_ptr<detail::change_subscriber_list> m_list;
+    std::shared_ptr<detail::change_subscriber> m_subscriber;
+};
+
+/**
+ * @brief A versioning policy that, on top of keeping a write version (see `write_versioning`),
+ * lets other components subscribe to the changes of a `mutex_guarded<...>` instead of polling it.
+ *
+ * Subscribers are notified after a proxy that granted write access has released its lock, on the
+ * thread that released it, with the lock no longer held. This includes a proxy that waits for a
+ * condition (see `condition_notification`), which notifies the subscribers before it starts
+ * waiting, unless the predicate already holds. Notifications are coalesced by version:
+ * each subscriber receives the latest version at the time its callback is invoked, and writes that
+ * happen while its callback runs result in a single further notification, which is delivered on
+ * the callback's thread once it returns, rather than blocking the writers.
+ */
+struct write_subscriptions
+{
+    static constexpr bool is_enabled = true;
+    static constexpr bool publishes_changes = true;
+
+    /**
+     * @brief The state that the policy adds to each guard.
+     */
+    class storage : public write_versioning::storage
+    {
+        template <typename B, typename L> friend class lock_proxy;
+
+      public:
+        /**
+         * @brief Registers a callback that is invoked after writes to the guard. Can be called
+         * from any thread, with or without holding the lock.
+         *
+         * @param[in] callback            A callable that takes the version of the data that it's
+         *                                being notified of. It must not throw, and may lock the
+         *                                guard itself; note that releasing a lock that grants write
+         *                                access counts as a write, so the data is best read
+         *                                through the const guard.
+         *
+         * @returns A handle that keeps the callback registered for as long as it lives.
+         */
+        template <typename CallbackType>
+        auto subscribe(CallbackType&& callback) const -> change_subscription
+        {
+            auto subscriber = std::make_shared<detail::change_subscriber>(
+                std::function<void(std::uint64_t)>{ std::forward<CallbackType>(callback) });
+
+            m_subscribers->add(subscriber);
+            return { m_subscribers, std::move(subscriber) };
+        }
+
+      private:
+        /**
+         * @brief Notifies the subscribers of the current version, unless another proxy has done so
+         * already. Read-only proxies only pay for an atomic load.
+         */
+        void publish_changes() const noexcept
+        {
+            const auto current = version();
+
+            auto published = m_published.load(std::memory_order_acquire);
+            do {
+                if (published >= current) {
+                    return;
+                }
+            } while (!m_published.compare_exchange_weak(
+                published, current, std::memory_order_acq_rel, std::memory_order_acquire));
+
+            m_subscribers->notify(current);
+        }
+
+        mutable std::atomic<std::uint64_t> m_published{ 0 };
+        std::shared_ptr<detail::change_subscriber_list> m_subscribers =
+            std::make_shared<detail::change_subscriber_list>();
+    };
+};
+
+/**
+ * @brief A `mutex_guarded<...>` that components can subscribe to, in order to react to changes of
+ * the data.
+ *
+ * Usage:
+ *
+ *     observable_guarded<settings> config;
+ *
+ *     const auto subscription = config.subscribe([&](std::uint64_t) {
+ *         apply(*std::as_const(config).lock());
+ *     });
+ *
+ *     config.lock()->theme = "dark"; // Applied once the lock has been released.
+ */
+template <typename DataType, typename MutexType = std::mutex>
+using observable_guarded = mutex_guarded<
+    DataType, MutexType, compact_layout, no_statistics, no_notification, write_subscriptions>;
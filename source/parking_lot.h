@@ -0,0 +1,99 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace detail
+{
+/**
+ * @brief A global table of wait queues, keyed by address, that lets lock implementations block
+ * threads without having to embed a mutex and a condition variable in every lock instance.
+ *
+ * Threads parked on different addresses may share a bucket, and so every parked thread has to
+ * re-validate its wait condition upon waking up.
+ */
+class parking_lot
+{
+  public:
+    /**
+     * @brief Parks the calling thread on the given address, provided that the `should_park`
+     * predicate returns true. The predicate is evaluated with the bucket lock held, and so any
+     * state that it observes can't change in a way that would cause a missed wake-up, as long as
+     * the waking thread calls `unpark_all(...)` after making its change.
+     *
+     * @param[in] address             The address to park on.
+     * @param[in] should_park         A predicate that returns false if the calling thread no
+     *                                longer needs to wait.
+     */
+    template <typename PredicateType>
+    static void park(const void* address, PredicateType&& should_park)
+    {
+        auto& bucket = bucket_for(address);
+
+        std::unique_lock<std::mutex> lock{ bucket.mutex };
+        if (should_park()) {
+            bucket.condition.wait(lock);
+        }
+    }
+
+    /**
+     * @brief Like `park(...)`, but gives up once the deadline passes.
+     *
+     * @returns False if the deadline had already passed or if the wait timed out; true otherwise.
+     */
+    template <typename PredicateType, typename ClockType, typename DurationType>
+    static auto park_until(
+        const void* address, PredicateType&& should_park,
+        const std::chrono::time_point<ClockType, DurationType>& deadline) -> bool
+    {
+        auto& bucket = bucket_for(address);
+
+        std::unique_lock<std::mutex> lock{ bucket.mutex };
+        if (!should_park()) {
+            return true;
+        }
+
+        return bucket.condition.wait_until(lock, deadline) == std::cv_status::no_timeout;
+    }
+
+    /**
+     * @brief Wakes up all threads parked on the given address (as well as any threads parked on
+     * other addresses that happen to map onto the same bucket).
+     */
+    static void unpark_all(const void* address)
+    {
+        auto& bucket = bucket_for(address);
+
+        {
+            // Acquiring the lock ensures that any thread that has evaluated its predicate is
+            // actually waiting on the condition by the time that we notify it.
+            const std::lock_guard<std::mutex> lock{ bucket.mutex };
+        }
+
+        bucket.condition.notify_all();
+    }
+
+  private:
+    struct alignas(cache_line_size) bucket
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    static constexpr std::size_t bucket_count = 64;
+
+    static auto bucket_for(const void* address) -> bucket&
+    {
+        static std::array<bucket, bucket_count> buckets;
+
+        // Discard the low bits, since they're mostly determined by alignment.
+        const auto key = reinterpret_cast<std::uintptr_t>(address) >> 4;
+        return buckets[(key ^ (key >> 6) ^ (key >> 12)) % bucket_count];
+    }
+};
+} // namespace detail
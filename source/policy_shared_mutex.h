@@ -0,0 +1,315 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+namespace detail
+{
+/**
+ * @brief The bookkeeping of a `policy_shared_mutex`, which the policies base their decisions on.
+ */
+struct shared_mutex_state
+{
+    std::size_t readers = 0;
+    bool is_write_locked = false;
+
+    std::size_t waiting_readers = 0;
+    std::size_t waiting_writers = 0;
+
+    // Incremented whenever a writer hands the lock to all waiting readers at once.
+    std::uint64_t read_phase = 0;
+};
+} // namespace detail
+
+/**
+ * @brief Lets new readers in whenever no writer holds the lock. Readers never wait for readers, but
+ * a steady stream of readers starves writers.
+ */
+struct reader_preferring
+{
+    static auto admits_reader(const detail::shared_mutex_state& state) noexcept -> bool
+    {
+        return !state.is_write_locked;
+    }
+
+    static constexpr bool hands_over_to_waiting_readers = false;
+};
+
+/**
+ * @brief Holds off new readers while a writer is waiting, and passes the lock from writer to writer
+ * for as long as writers are waiting. Writers never starve, but readers can.
+ */
+struct writer_preferring
+{
+    static auto admits_reader(const detail::shared_mutex_state& state) noexcept -> bool
+    {
+        return !state.is_write_locked && state.waiting_writers == 0;
+    }
+
+    static constexpr bool hands_over_to_waiting_readers = false;
+};
+
+/**
+ * @brief Alternates between read and write phases: new readers wait while a writer is waiting, and
+ * a writer that releases the lock hands it to all readers that queued up in the meantime, before
+ * the next writer gets its turn. Neither side can starve, and a reader waits for at most one
+ * writer.
+ */
+struct phase_fair
+{
+    static auto admits_reader(const detail::shared_mutex_state& state) noexcept -> bool
+    {
+        return !state.is_write_locked && state.waiting_writers == 0;
+    }
+
+    static constexpr bool hands_over_to_waiting_readers = true;
+};
+
+namespace detail
+{
+/**
+ * @brief The implementation of `policy_shared_mutex` and `policy_shared_timed_mutex`. The state is
+ * guarded by an internal mutex, and readers and writers wait on separate condition variables, so
+ * that the policy alone decides who gets the lock next.
+ */
+template <typename PolicyType> class policy_shared_mutex_base
+{
+  public:
+    policy_shared_mutex_base() = default;
+
+    policy_shared_mutex_base(const policy_shared_mutex_base&) = delete;
+    policy_shared_mutex_base& operator=(const policy_shared_mutex_base&) = delete;
+
+    void lock()
+    {
+        lock_until<std::nullptr_t>(nullptr);
+    }
+
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        const std::lock_guard<std::mutex> guard{ m_mutex };
+        if (!can_write()) {
+            return false;
+        }
+
+        m_state.is_write_locked = true;
+        return true;
+    }
+
+    void unlock()
+    {
+        const std::lock_guard<std::mutex> guard{ m_mutex };
+        m_state.is_write_locked = false;
+
+        // The condition variables are notified under the mutex, since a thread that acquires the
+        // lock right after it has been released might otherwise destroy them.
+        if (PolicyType::hands_over_to_waiting_readers && m_state.waiting_readers > 0) {
+            m_state.readers += m_state.waiting_readers;
+            m_state.waiting_readers = 0;
+            ++m_state.read_phase;
+
+            m_reader_condition.notify_all();
+            return;
+        }
+
+        if (m_state.waiting_writers > 0) {
+            m_writer_condition.notify_one();
+        }
+
+        if (m_state.waiting_readers > 0 && PolicyType::admits_reader(m_state)) {
+            m_reader_condition.notify_all();
+        }
+    }
+
+    void lock_shared()
+    {
+        lock_shared_until<std::nullptr_t>(nullptr);
+    }
+
+    [[nodiscard]] auto try_lock_shared() -> bool
+    {
+        const std::lock_guard<std::mutex> guard{ m_mutex };
+        if (!PolicyType::admits_reader(m_state)) {
+            return false;
+        }
+
+        ++m_state.readers;
+        return true;
+    }
+
+    void unlock_shared()
+    {
+        const std::lock_guard<std::mutex> guard{ m_mutex };
+        if (--m_state.readers == 0 && m_state.waiting_writers > 0) {
+            m_writer_condition.notify_one();
+        }
+    }
+
+  protected:
+    /**
+     * @brief Waits for exclusive access until the deadline passes, or indefinitely if the deadline
+     * is a null pointer.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename TimePointType> auto lock_until(const TimePointType* deadline) -> bool
+    {
+        std::unique_lock<std::mutex> guard{ m_mutex };
+
+        ++m_state.waiting_writers;
+        const auto is_acquired =
+            wait(guard, m_writer_condition, deadline, [&] { return can_write(); });
+        --m_state.waiting_writers;
+
+        if (is_acquired) {
+            m_state.is_write_locked = true;
+            return true;
+        }
+
+        // Readers might have been held back by this writer.
+        if (m_state.waiting_readers > 0 && PolicyType::admits_reader(m_state)) {
+            m_reader_condition.notify_all();
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Waits for shared access until the deadline passes, or indefinitely if the deadline is
+     * a null pointer.
+     *
+     * @returns True if the lock was acquired.
+     */
+    template <typename TimePointType> auto lock_shared_until(const TimePointType* deadline) -> bool
+    {
+        std::unique_lock<std::mutex> guard{ m_mutex };
+
+        const auto phase = m_state.read_phase;
+        const auto is_handed_over = [&] { return m_state.read_phase != phase; };
+
+        ++m_state.waiting_readers;
+        const auto is_admitted = wait(guard, m_reader_condition, deadline, [&] {
+            return is_handed_over() || PolicyType::admits_reader(m_state);
+        });
+
+        // A writer that hands over the lock counts its waiting readers as holders on their behalf,
+        // even if their deadline has passed in the meantime.
+        if (is_handed_over()) {
+            return true;
+        }
+
+        --m_state.waiting_readers;
+        if (!is_admitted) {
+            return false;
+        }
+
+        ++m_state.readers;
+        return true;
+    }
+
+  private:
+    auto can_write() const noexcept -> bool
+    {
+        return !m_state.is_write_locked && m_state.readers == 0;
+    }
+
+    template <typename TimePointType, typename PredicateType>
+    static auto wait(
+        std::unique_lock<std::mutex>& guard, std::condition_variable& condition,
+        const TimePointType* deadline, PredicateType predicate) -> bool
+    {
+        if constexpr (std::is_same_v<TimePointType, std::nullptr_t>) {
+            condition.wait(guard, predicate);
+            return true;
+        } else {
+            return condition.wait_until(guard, *deadline, predicate);
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_reader_condition;
+    std::condition_variable m_writer_condition;
+
+    shared_mutex_state m_state;
+};
+} // namespace detail
+
+/**
+ * @brief A reader-writer mutex whose policy decides whether readers or writers get the lock first:
+ * `reader_preferring`, `writer_preferring`, or `phase_fair` (the default). Unlike with a
+ * `std::shared_mutex`, whose policy depends on the platform, the bounds on how long readers and
+ * writers wait are thus known up front.
+ *
+ * This mutex satisfies the SharedMutex concept.
+ */
+template <typename PolicyType = phase_fair>
+class policy_shared_mutex : private detail::policy_shared_mutex_base<PolicyType>
+{
+    using base_type = detail::policy_shared_mutex_base<PolicyType>;
+
+  public:
+    using base_type::lock;
+    using base_type::try_lock;
+    using base_type::unlock;
+
+    using base_type::lock_shared;
+    using base_type::try_lock_shared;
+    using base_type::unlock_shared;
+};
+
+/**
+ * @brief A `policy_shared_mutex` that also supports timed lock acquisition.
+ *
+ * This mutex satisfies the SharedTimedMutex concept.
+ */
+template <typename PolicyType = phase_fair>
+class policy_shared_timed_mutex : private detail::policy_shared_mutex_base<PolicyType>
+{
+    using base_type = detail::policy_shared_mutex_base<PolicyType>;
+
+  public:
+    using base_type::lock;
+    using base_type::try_lock;
+    using base_type::unlock;
+
+    using base_type::lock_shared;
+    using base_type::try_lock_shared;
+    using base_type::unlock_shared;
+
+    template <typename RepType, typename PeriodType>
+    [[nodiscard]] auto try_lock_for(const std::chrono::duration<RepType, PeriodType>& timeout)
+        -> bool
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename ClockType, typename DurationType>
+    [[nodiscard]] auto
+    try_lock_until(const std::chrono::time_point<ClockType, DurationType>& deadline) -> bool
+    {
+        return base_type::lock_until(&deadline);
+    }
+
+    template <typename RepType, typename PeriodType>
+    [[nodiscard]] auto
+    try_lock_shared_for(const std::chrono::duration<RepType, PeriodType>& timeout) -> bool
+    {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename ClockType, typename DurationType>
+    [[nodiscard]] auto
+    try_lock_shared_until(const std::chrono::time_point<ClockType, DurationType>& deadline) -> bool
+    {
+        return base_type::lock_shared_until(&deadline);
+    }
+};
+
+using phase_fair_shared_mutex = policy_shared_mutex<phase_fair>;
+using phase_fair_shared_timed_mutex = policy_shared_timed_mutex<phase_fair>;
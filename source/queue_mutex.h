@@ -0,0 +1,476 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace detail
+{
+struct queue_inspector;
+
+/**
+ * @brief A node in the queue of an `mcs_mutex` or a `clh_mutex`. Every node occupies its own cache
+ * line, so that each waiter spins on a line that only its predecessor writes to.
+ */
+struct alignas(cache_line_size) queue_node
+{
+    std::atomic<queue_node*> next{ nullptr };
+    std::atomic<bool> is_locked{ false };
+};
+
+/**
+ * @brief Hands out queue nodes from a per-thread cache, so that acquiring a queue lock doesn't
+ * allocate in the common case.
+ *
+ * Nodes are never freed. When a thread exits, its cached nodes are moved to a global reserve, from
+ * which other threads replenish their caches. This keeps the memory behind every node valid for
+ * the lifetime of the process, so that a thread can safely inspect a node that another thread has
+ * just released. The number of nodes is bounded by the peak number of concurrent acquisitions.
+ */
+class queue_node_pool
+{
+  public:
+    queue_node_pool() = default;
+
+    queue_node_pool(const queue_node_pool&) = delete;
+    queue_node_pool& operator=(const queue_node_pool&) = delete;
+
+    ~queue_node_pool() noexcept
+    {
+        while (m_nodes) {
+            auto* const node = pop(m_nodes);
+            reserve().give_back(node);
+        }
+    }
+
+    /**
+     * @returns The pool of the calling thread.
+     */
+    static auto local() -> queue_node_pool&
+    {
+        thread_local queue_node_pool pool;
+        return pool;
+    }
+
+    auto acquire() -> queue_node*
+    {
+        if (m_nodes) {
+            return pop(m_nodes);
+        }
+
+        if (auto* const node = reserve().take()) {
+            return node;
+        }
+
+        return new queue_node;
+    }
+
+    void release(queue_node* node) noexcept
+    {
+        push(m_nodes, node);
+    }
+
+    /**
+     * @brief Returns a node that no thread owns anymore, such as the final node of a destroyed
+     * lock, to the global reserve.
+     */
+    static void retire(queue_node* node)
+    {
+        reserve().give_back(node);
+    }
+
+  private:
+    /**
+     * @brief The nodes that were left behind by threads that have exited.
+     */
+    class global_reserve
+    {
+      public:
+        auto take() -> queue_node*
+        {
+            const std::lock_guard<std::mutex> guard{ m_mutex };
+            return m_nodes ? pop(m_nodes) : nullptr;
+        }
+
+        void give_back(queue_node* node)
+        {
+            const std::lock_guard<std::mutex> guard{ m_mutex };
+            push(m_nodes, node);
+        }
+
+      private:
+        std::mutex m_mutex;
+        queue_node* m_nodes = nullptr;
+    };
+
+    static auto reserve() -> global_reserve&
+    {
+        // Never destroyed, since threads may still exit during static destruction.
+        static auto* const instance = new global_reserve;
+        return *instance;
+    }
+
+    static void push(queue_node*& list, queue_node* node) noexcept
+    {
+        node->next.store(list, std::memory_order_relaxed);
+        list = node;
+    }
+
+    static auto pop(queue_node*& list) noexcept -> queue_node*
+    {
+        auto* const node = list;
+        list = node->next.load(std::memory_order_relaxed);
+        return node;
+    }
+
+    queue_node* m_nodes = nullptr;
+};
+
+/**
+ * @brief Spins until the flag is cleared, but periodically yields, so that a lock holder that was
+ * preempted gets a chance to finish when there are more threads than cores.
+ */
+inline void spin_while_locked(const std::atomic<bool>& is_locked) noexcept
+{
+    for (std::uint32_t spin = 1; is_locked.load(std::memory_order_acquire); ++spin) {
+        if (spin % 64 == 0) {
+            std::this_thread::yield();
+        } else {
+            cpu_relax();
+        }
+    }
+}
+} // namespace detail
+
+/**
+ * @brief A fair spin lock, which grants the lock in the order in which it was requested by handing
+ * out tickets. At eight bytes, it is the smallest of the fair locks, but all waiters spin on the
+ * same cache line, so it degrades under heavy contention; waiters back off in proportion to their
+ * distance from the head of the line to soften this.
+ *
+ * This mutex satisfies the Mutex concept.
+ */
+class ticket_mutex
+{
+    friend struct detail::queue_inspector;
+
+  public:
+    ticket_mutex() = default;
+
+    ticket_mutex(const ticket_mutex&) = delete;
+    ticket_mutex& operator=(const ticket_mutex&) = delete;
+
+    void lock() noexcept
+    {
+        const auto ticket = m_next_ticket.fetch_add(1, std::memory_order_relaxed);
+
+        for (std::uint32_t attempt = 1;; ++attempt) {
+            const auto serving = m_now_serving.load(std::memory_order_acquire);
+            if (serving == ticket) {
+                return;
+            }
+
+            if (attempt % 64 == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (auto distance = ticket - serving; distance > 0; --distance) {
+                detail::cpu_relax();
+            }
+        }
+    }
+
+    [[nodiscard]] auto try_lock() noexcept -> bool
+    {
+        // Acquire pairs with the release in `unlock()`, which publishes the previous writes.
+        auto ticket = m_now_serving.load(std::memory_order_acquire);
+        return m_next_ticket.compare_exchange_strong(
+            ticket, ticket + 1, std::memory_order_relaxed, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        // Only the lock holder ever writes to this counter:
+        const auto serving = m_now_serving.load(std::memory_order_relaxed);
+        m_now_serving.store(serving + 1, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<std::uint32_t> m_next_ticket{ 0 };
+    std::atomic<std::uint32_t> m_now_serving{ 0 };
+};
+
+/**
+ * @brief The queue lock by Mellor-Crummey and Scott. Waiters form a linked list, and each waiter
+ * spins on a flag in its own node, which its predecessor clears when it hands over the lock. As a
+ * result, handing over the lock costs a constant number of cache misses, regardless of the number
+ * of waiters, and the lock is granted in FIFO order.
+ *
+ * Queue nodes are taken from a per-thread pool, so, like all standard mutexes, the lock has to be
+ * released by the thread that acquired it.
+ *
+ * This mutex satisfies the Mutex concept.
+ */
+class mcs_mutex
+{
+    friend struct detail::queue_inspector;
+
+  public:
+    mcs_mutex() = default;
+
+    mcs_mutex(const mcs_mutex&) = delete;
+    mcs_mutex& operator=(const mcs_mutex&) = delete;
+
+    void lock()
+    {
+        auto* const node = prepare_node();
+
+        auto* const predecessor = m_tail.exchange(node, std::memory_order_acq_rel);
+        if (predecessor) {
+            predecessor->next.store(node, std::memory_order_release);
+            detail::spin_while_locked(node->is_locked);
+        }
+
+        m_holder = node;
+    }
+
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        if (m_tail.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        auto* const node = prepare_node();
+
+        detail::queue_node* expected = nullptr;
+        if (!m_tail.compare_exchange_strong(
+                expected, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+            detail::queue_node_pool::local().release(node);
+            return false;
+        }
+
+        m_holder = node;
+        return true;
+    }
+
+    void unlock() noexcept
+    {
+        auto* const node = m_holder;
+
+        auto* successor = node->next.load(std::memory_order_acquire);
+        if (!successor) {
+            auto* expected = node;
+            if (m_tail.compare_exchange_strong(
+                    expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                detail::queue_node_pool::local().release(node);
+                return;
+            }
+
+            // A successor has swapped itself in, but hasn't linked itself to our node just yet.
+            while (!(successor = node->next.load(std::memory_order_acquire))) {
+                detail::cpu_relax();
+            }
+        }
+
+        successor->is_locked.store(false, std::memory_order_release);
+        detail::queue_node_pool::local().release(node);
+    }
+
+  private:
+    static auto prepare_node() -> detail::queue_node*
+    {
+        auto* const node = detail::queue_node_pool::local().acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->is_locked.store(true, std::memory_order_relaxed);
+
+        return node;
+    }
+
+    std::atomic<detail::queue_node*> m_tail{ nullptr };
+
+    // Only ever accessed by the lock holder.
+    detail::queue_node* m_holder = nullptr;
+};
+
+/**
+ * @brief The queue lock by Craig, Landin, and Hagersten. Waiters form an implicit queue: each
+ * waiter spins on a flag in its predecessor's node, which the predecessor clears when it releases
+ * the lock. Unlike an `mcs_mutex`, releasing the lock never has to wait for a successor to link
+ * itself in, at the cost of spinning on a node that was written by another thread.
+ *
+ * A thread that releases the lock adopts its predecessor's node for future use, since its own node
+ * is still being watched by its successor.
+ *
+ * A `try_lock()` that finds the lock free joins the queue with a single compare-and-swap on the
+ * tail. If the tail node was recycled and locked again in between, it leaves the queue again
+ * rather than waiting: it either swaps the tail back, or, if a successor has already queued up
+ * behind it, leaves a forwarding pointer to its own predecessor in its node's `next` field, which
+ * the successor follows (and then recycles the abandoned node).
+ *
+ * This mutex satisfies the Mutex concept.
+ */
+class clh_mutex
+{
+    friend struct detail::queue_inspector;
+
+  public:
+    clh_mutex() : m_tail{ detail::queue_node_pool::local().acquire() }
+    {
+        auto* const node = m_tail.load(std::memory_order_relaxed);
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->is_locked.store(false, std::memory_order_relaxed);
+    }
+
+    ~clh_mutex() noexcept
+    {
+        detail::queue_node_pool::retire(m_tail.load(std::memory_order_relaxed));
+    }
+
+    clh_mutex(const clh_mutex&) = delete;
+    clh_mutex& operator=(const clh_mutex&) = delete;
+
+    void lock()
+    {
+        auto* const node = prepare_node();
+        auto* const predecessor = m_tail.exchange(node, std::memory_order_acq_rel);
+
+        auto* const released = wait_for_release(predecessor);
+
+        m_holder = node;
+        m_predecessor = released;
+    }
+
+    /**
+     * @brief Attempts to acquire the lock if it looks free, without ever waiting for it.
+     */
+    [[nodiscard]] auto try_lock() -> bool
+    {
+        auto* tail = m_tail.load(std::memory_order_relaxed);
+        if (tail->is_locked.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        auto* const node = prepare_node();
+        if (!m_tail.compare_exchange_strong(
+                tail, node, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            detail::queue_node_pool::local().release(node);
+            return false;
+        }
+
+        if (!tail->is_locked.load(std::memory_order_acquire)) {
+            m_holder = node;
+            m_predecessor = tail;
+            return true;
+        }
+
+        // The tail node was recycled and locked again after it was found to be free.
+        abandon(node, tail);
+        return false;
+    }
+
+    void unlock() noexcept
+    {
+        auto* const predecessor = m_predecessor;
+
+        m_holder->is_locked.store(false, std::memory_order_release);
+        detail::queue_node_pool::local().release(predecessor);
+    }
+
+  private:
+    static auto prepare_node() -> detail::queue_node*
+    {
+        auto* const node = detail::queue_node_pool::local().acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->is_locked.store(true, std::memory_order_relaxed);
+
+        return node;
+    }
+
+    /**
+     * @brief Spins until the predecessor releases the lock, skipping over (and recycling) nodes
+     * that were abandoned by a `try_lock()`.
+     *
+     * @returns The node that released the lock, which the caller adopts once it unlocks.
+     */
+    static auto wait_for_release(detail::queue_node* predecessor) -> detail::queue_node*
+    {
+        for (std::uint32_t spin = 1; predecessor->is_locked.load(std::memory_order_acquire);
+             ++spin) {
+            if (auto* const forwarded = predecessor->next.load(std::memory_order_acquire)) {
+                detail::queue_node_pool::local().release(predecessor);
+                predecessor = forwarded;
+            } else if (spin % 64 == 0) {
+                std::this_thread::yield();
+            } else {
+                detail::cpu_relax();
+            }
+        }
+
+        return predecessor;
+    }
+
+    /**
+     * @brief Leaves the queue that a failed `try_lock()` joined, without waiting.
+     */
+    void abandon(detail::queue_node* node, detail::queue_node* predecessor) noexcept
+    {
+        // Without a successor, no other thread knows about the node, so it can be reused at once.
+        auto* expected = node;
+        if (m_tail.compare_exchange_strong(
+                expected, predecessor, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            detail::queue_node_pool::local().release(node);
+            return;
+        }
+
+        // Otherwise, the successor takes over the node once it has followed the forwarding
+        // pointer, so this must be the last access to it.
+        node->next.store(predecessor, std::memory_order_release);
+    }
+
+    std::atomic<detail::queue_node*> m_tail;
+
+    // Only ever accessed by the lock holder.
+    detail::queue_node* m_holder = nullptr;
+    detail::queue_node* m_predecessor = nullptr;
+};
+
+namespace detail
+{
+/**
+ * @brief Observes the queue of a fair spin lock without taking part in it, so that tests can wait
+ * for a thread to have joined the queue, rather than relying on timing.
+ */
+struct queue_inspector
+{
+    /**
+     * @returns A value that changes whenever a thread joins the queue, i.e., the last ticket that
+     * was handed out.
+     */
+    static auto tail(const ticket_mutex& mutex) noexcept -> std::uintptr_t
+    {
+        return mutex.m_next_ticket.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @returns A value that changes whenever a thread joins the queue, i.e., the address of the
+     * node at the end of the queue.
+     */
+    static auto tail(const mcs_mutex& mutex) noexcept -> std::uintptr_t
+    {
+        return reinterpret_cast<std::uintptr_t>(mutex.m_tail.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @returns A value that changes whenever a thread joins the queue, i.e., the address of the
+     * node at the end of the queue.
+     */
+    static auto tail(const clh_mutex& mutex) noexcept -> std::uintptr_t
+    {
+        return reinterpret_cast<std::uintptr_t>(mutex.m_tail.load(std::memory_order_acquire));
+    }
+};
+} // namespace detail
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace detail
+{
+/**
+ * @brief A per-thread announcement of the epoch in which the thread entered a read-side critical
+ * section. An epoch of zero means that the thread is not currently reading.
+ *
+ * Each slot lives on its own cache line, so that readers only ever write to memory that no other
+ * reader touches.
+ */
+struct alignas(cache_line_size) rcu_reader_slot
+{
+    std::atomic<std::uint64_t> epoch{ 0 };
+    std::atomic<bool> is_claimed{ true };
+    rcu_reader_slot* next = nullptr;
+};
+
+/**
+ * @brief Tracks all reader slots, and implements the grace period that writers wait out before
+ * reclaiming a version that readers may still be looking at.
+ *
+ * A single domain is shared by all `rcu_guarded<...>` instances.
+ */
+class rcu_domain
+{
+  public:
+    static auto instance() -> rcu_domain&
+    {
+        static rcu_domain domain;
+        return domain;
+    }
+
+    rcu_domain(const rcu_domain&) = delete;
+    rcu_domain& operator=(const rcu_domain&) = delete;
+
+    ~rcu_domain() noexcept
+    {
+        auto* slot = m_slots.load(std::memory_order_acquire);
+        while (slot) {
+            delete std::exchange(slot, slot->next);
+        }
+    }
+
+    /**
+     * @returns A reader slot for the exclusive use of the calling thread. Slots are recycled once
+     * their owning thread exits.
+     */
+    auto claim_slot() -> rcu_reader_slot*
+    {
+        for (auto* slot = m_slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+            bool expected = false;
+            if (slot->is_claimed.compare_exchange_strong(expected, true)) {
+                return slot;
+            }
+        }
+
+        auto* slot = new rcu_reader_slot;
+        slot->next = m_slots.load(std::memory_order_relaxed);
+
+        while (!m_slots.compare_exchange_weak(
+            slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+
+        return slot;
+    }
+
+    auto current_epoch() const noexcept -> std::uint64_t
+    {
+        return m_epoch.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Blocks until every reader that may have observed a previously published version has
+     * left its read-side critical section.
+     *
+     * This must not be called from within a read-side critical section, since it would then wait
+     * on itself.
+     */
+    void synchronize() const
+    {
+        // Readers that announce an epoch at or beyond the target are guaranteed to observe the
+        // newly published version, and so they don't need to be waited on.
+        const auto target = m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        for (auto* slot = m_slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+            for (std::uint32_t attempt = 1;; ++attempt) {
+                const auto epoch = slot->epoch.load(std::memory_order_acquire);
+                if (epoch == 0 || epoch >= target) {
+                    break;
+                }
+
+                if (attempt % 64 == 0) {
+                    std::this_thread::yield();
+                } else {
+                    cpu_relax();
+                }
+            }
+        }
+    }
+
+  private:
+    rcu_domain() = default;
+
+    mutable std::atomic<std::uint64_t> m_epoch{ 1 };
+    std::atomic<rcu_reader_slot*> m_slots{ nullptr };
+};
+
+/**
+ * @brief The read-side state of the calling thread.
+ */
+struct rcu_thread_state
+{
+    rcu_reader_slot* slot = nullptr;
+    std::uint32_t nesting = 0;
+
+    ~rcu_thread_state() noexcept
+    {
+        if (slot) {
+            slot->is_claimed.store(false, std::memory_order_release);
+        }
+    }
+};
+
+inline auto rcu_this_thread() -> rcu_thread_state&
+{
+    thread_local rcu_thread_state state;
+    return state;
+}
+
+/**
+ * @brief A RAII guard that marks a read-side critical section. Guards can be nested.
+ */
+class rcu_read_guard
+{
+  public:
+    rcu_read_guard() : m_state{ rcu_this_thread() }
+    {
+        if (m_state.nesting++ > 0) {
+            return;
+        }
+
+        auto& domain = rcu_domain::instance();
+        if (!m_state.slot) {
+            m_state.slot = domain.claim_slot();
+        }
+
+        m_state.slot->epoch.store(domain.current_epoch(), std::memory_order_relaxed);
+
+        // Pairs with the fence in `rcu_domain::synchronize()`: either the writer sees this
+        // announcement, or this reader sees the writer's newly published version.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    ~rcu_read_guard() noexcept
+    {
+        if (--m_state.nesting == 0) {
+            m_state.slot->epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    rcu_read_guard(const rcu_read_guard&) = delete;
+    rcu_read_guard& operator=(const rcu_read_guard&) = delete;
+
+  private:
+    rcu_thread_state& m_state;
+};
+} // namespace detail
+
+/**
+ * @brief A RAII proxy that grants read-only access to an immutable snapshot of the data guarded by
+ * an `rcu_guarded<...>` instance. The snapshot remains valid for as long as the proxy is alive.
+ */
+template <typename DataType> class [[nodiscard]] rcu_read_proxy
+{
+  public:
+    using value_type = DataType;
+    using const_pointer = const value_type*;
+    using const_reference = const value_type&;
+
+    rcu_read_proxy(const std::atomic<DataType*>& data)
+        : m_data{ data.load(std::memory_order_acquire) }
+    {
+    }
+
+    rcu_read_proxy(const rcu_read_proxy&) = delete;
+    rcu_read_proxy& operator=(const rcu_read_proxy&) = delete;
+
+    auto is_locked() const noexcept -> bool
+    {
+        return true;
+    }
+
+    auto operator->() const noexcept -> const_pointer
+    {
+        return m_data;
+    }
+
+    auto operator*() const noexcept -> const_reference
+    {
+        return *m_data;
+    }
+
+  private:
+    // The guard has to be constructed before the pointer is loaded.
+    detail::rcu_read_guard m_guard;
+    const DataType* m_data;
+};
+
+/**
+ * @brief A wrapper that guards data using Read-Copy-Update (RCU).
+ *
+ * Readers obtain an immutable snapshot through an atomically published pointer, and never block
+ * or wait on writers (or on each other). Writers serialize on a mutex, modify a private copy of the
+ * data, and then publish that copy. The previous version is destroyed once every reader that might
+ * still be looking at it has finished.
+ *
+ * This makes reads nearly free, at the cost of a copy and a grace period per write. As such, this
+ * class is best suited to data that is read very frequently, but modified only rarely.
+ *
+ * The read and write functions mirror those of a `mutex_guarded<DataType, std::shared_mutex>`,
+ * so that switching between the two only requires a change of type.
+ *
+ * @note Writes must not be performed from within a read-side critical section (that is, while a
+ * read proxy is alive, or from within a `with_read_lock_held(...)` functor) on the same thread,
+ * since the writer would then wait on itself.
+ */
+template <typename DataType, typename MutexType = std::mutex> class rcu_guarded
+{
+    static_assert(
+        std::is_copy_constructible_v<DataType>,
+        "An rcu_guarded<...> needs to be able to copy the data in order to modify it.");
+
+    static_assert(
+        detail::traits::is_mutex<MutexType>::value, "The MutexType must support the Mutex concept");
+
+  public:
+    using value_type = DataType;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using mutex_type = MutexType;
+
+    using shared_lock_proxy = const rcu_read_proxy<DataType>;
+
+    rcu_guarded() : m_data{ new DataType{} }
+    {
+    }
+
+    rcu_guarded(DataType data) : m_data{ new DataType{ std::move(data) } }
+    {
+    }
+
+    rcu_guarded(const rcu_guarded&) = delete;
+    rcu_guarded& operator=(const rcu_guarded&) = delete;
+
+    ~rcu_guarded() noexcept
+    {
+        delete m_data.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns a proxy that grants read-only access to the current version of the data.
+     *
+     * @returns An RAII proxy.
+     */
+    auto read_lock() const -> shared_lock_proxy
+    {
+        return { m_data };
+    }
+
+    /**
+     * @brief Executes the passed in functor on the current version of the data.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    decltype(auto) with_read_lock_held(CallableType&& callable) const
+    {
+        const auto proxy = read_lock();
+        return callable(*proxy);
+    }
+
+    /**
+     * @brief Copies the current version of the data, executes the passed in functor on that copy,
+     * and then publishes the modified copy to readers.
+     *
+     * This function blocks until the previous version can be safely destroyed.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> decltype(auto) with_write_lock_held(CallableType&& callable)
+    {
+        std::unique_lock<MutexType> lock{ m_mutex };
+
+        // Since writers are serialized, the current version can't be reclaimed while we copy it.
+        auto copy = std::make_unique<DataType>(*m_data.load(std::memory_order_relaxed));
+
+        if constexpr (std::is_void_v<decltype(callable(*copy))>) {
+            callable(*copy);
+            publish(std::move(copy), lock);
+        } else {
+            auto result = callable(*copy);
+            publish(std::move(copy), lock);
+            return result;
+        }
+    }
+
+    /**
+     * @brief Replaces the data wholesale, without copying the current version first.
+     *
+     * This function blocks until the previous version can be safely destroyed.
+     */
+    void store(DataType data)
+    {
+        auto replacement = std::make_unique<DataType>(std::move(data));
+
+        std::unique_lock<MutexType> lock{ m_mutex };
+        publish(std::move(replacement), lock);
+    }
+
+  private:
+    /**
+     * @brief Publishes the new version, releases the writer lock, and then reclaims the previous
+     * version once all readers are done with it.
+     */
+    void publish(std::unique_ptr<DataType> replacement, std::unique_lock<MutexType>& lock)
+    {
+        assert(detail::rcu_this_thread().nesting == 0);
+
+        std::unique_ptr<DataType> previous{ m_data.exchange(
+            replacement.release(), std::memory_order_seq_cst) };
+
+        lock.unlock();
+
+        detail::rcu_domain::instance().synchronize();
+    }
+
+    std::atomic<DataType*> m_data;
+    MutexType m_mutex;
+};
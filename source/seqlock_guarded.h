@@ -0,0 +1,218 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief A wrapper around trivially copyable data that is guarded by a sequence lock.
+ *
+ * Writers are serialized by a mutex, and bump a sequence counter before and after modifying the
+ * data. Readers never write to shared memory: they optimistically copy the data, and then retry if
+ * the sequence counter indicates that a writer was active in the meantime. This makes reads very
+ * cheap and scalable, at the cost of having to copy the data on every access. As such, this class
+ * is best suited to small structs that are read far more often than they are written.
+ *
+ * The read and write functions mirror those of a `mutex_guarded<DataType, std::shared_mutex>`,
+ * so that switching between the two only requires a change of type.
+ */
+template <typename DataType, typename MutexType = std::mutex> class seqlock_guarded
+{
+    static_assert(
+        std::is_trivially_copyable_v<DataType>,
+        "A seqlock_guarded<...> can only guard trivially copyable data, since readers may copy "
+        "the data while it is being modified.");
+
+    static_assert(
+        std::is_default_constructible_v<DataType>,
+        "A seqlock_guarded<...> needs to be able to default construct a local copy of the data.");
+
+    static_assert(
+        detail::traits::is_mutex<MutexType>::value, "The MutexType must support the Mutex concept");
+
+    using word_type = std::uintptr_t;
+
+    static constexpr std::size_t word_count =
+        (sizeof(DataType) + sizeof(word_type) - 1) / sizeof(word_type);
+
+  public:
+    using value_type = DataType;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using mutex_type = MutexType;
+
+    seqlock_guarded() : seqlock_guarded{ DataType{} }
+    {
+    }
+
+    seqlock_guarded(const DataType& data)
+    {
+        store(data);
+    }
+
+    seqlock_guarded(const seqlock_guarded&) = delete;
+    seqlock_guarded& operator=(const seqlock_guarded&) = delete;
+
+    /**
+     * @brief Takes a consistent snapshot of the data, and then executes the passed in functor on
+     * that snapshot.
+     *
+     * Since the functor operates on a private copy, it is never exposed to a partially written
+     * value, and it does not block writers.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    decltype(auto) with_read_lock_held(CallableType&& callable) const
+    {
+        const DataType snapshot = read();
+        return callable(snapshot);
+    }
+
+    /**
+     * @brief Serializes against other writers, and then executes the passed in functor on a copy
+     * of the data. Once the functor returns, the modified copy is published to readers.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> decltype(auto) with_write_lock_held(CallableType&& callable)
+    {
+        const std::lock_guard<MutexType> guard{ m_mutex };
+
+        // Since writers are serialized, there's no need to validate this copy:
+        DataType data = load();
+
+        if constexpr (std::is_void_v<decltype(callable(data))>) {
+            callable(data);
+            publish(data);
+        } else {
+            auto result = callable(data);
+            publish(data);
+            return result;
+        }
+    }
+
+    /**
+     * @returns A consistent snapshot of the data.
+     */
+    auto read() const -> DataType
+    {
+        for (std::uint32_t attempt = 1;; ++attempt) {
+            const auto sequence = m_sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                // A writer is active, so there's no point in copying the data just yet.
+                back_off(attempt);
+                continue;
+            }
+
+            DataType data = load();
+
+            // Prevent the loads of the data from being reordered after the validating load:
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+                return data;
+            }
+
+            back_off(attempt);
+        }
+    }
+
+    /**
+     * @brief Replaces the data.
+     */
+    void write(const DataType& data)
+    {
+        const std::lock_guard<MutexType> guard{ m_mutex };
+        publish(data);
+    }
+
+    /**
+     * @returns The current value of the sequence counter. The counter is odd while a write is in
+     * progress, and it advances by two with every completed write.
+     */
+    auto sequence() const noexcept -> std::uint64_t
+    {
+        return m_sequence.load(std::memory_order_acquire);
+    }
+
+  private:
+    /**
+     * @brief Spins for a little while, but periodically yields so that a writer that was preempted
+     * in the middle of an update gets a chance to finish.
+     */
+    static void back_off(std::uint32_t attempt) noexcept
+    {
+        if (attempt % 64 == 0) {
+            std::this_thread::yield();
+        } else {
+            detail::cpu_relax();
+        }
+    }
+
+    /**
+     * @brief Copies the data out of the atomic words that back it.
+     */
+    auto load() const noexcept -> DataType
+    {
+        std::array<word_type, word_count> words;
+        for (std::size_t index = 0; index < word_count; ++index) {
+            words[index] = m_words[index].load(std::memory_order_relaxed);
+        }
+
+        DataType data;
+        std::memcpy(static_cast<void*>(&data), words.data(), sizeof(DataType));
+        return data;
+    }
+
+    /**
+     * @brief Copies the data into the atomic words that back it.
+     */
+    void store(const DataType& data) noexcept
+    {
+        std::array<word_type, word_count> words{};
+        std::memcpy(words.data(), &data, sizeof(DataType));
+
+        for (std::size_t index = 0; index < word_count; ++index) {
+            m_words[index].store(words[index], std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Stores the data, bracketed by sequence counter updates. The mutex must be held.
+     */
+    void publish(const DataType& data) noexcept
+    {
+        const auto sequence = m_sequence.load(std::memory_order_relaxed);
+
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+
+        // Prevent the stores to the data from being reordered before the odd sequence number:
+        std::atomic_thread_fence(std::memory_order_release);
+
+        store(data);
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    std::atomic<std::uint64_t> m_sequence{ 0 };
+
+    // The data is stored as a sequence of atomic words, since readers may race with writers.
+    std::array<std::atomic<word_type>, word_count> m_words;
+
+    MutexType m_mutex;
+};
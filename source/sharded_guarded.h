@@ -0,0 +1,515 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace detail
+{
+/**
+ * @brief Scrambles the bits of a hash, so that hash functions that map integers onto themselves
+ * still distribute keys evenly across the shards.
+ */
+constexpr auto mix_hash(std::uint64_t hash) noexcept -> std::uint64_t
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief Acquires a lock on every shard, in ascending index order, and then invokes the callable
+ * with pointers to the data of all shards.
+ *
+ * Since every thread acquires the shard locks in the same order, two threads that both lock all
+ * shards can't deadlock one another.
+ *
+ * @param[in] shards              The shards to lock.
+ * @param[in] pointers            Receives a pointer to the data of each locked shard.
+ * @param[in] locker              A functor that locks a single shard, returning a lock proxy.
+ * @param[in] callable            The functor to invoke once all shards have been locked.
+ *
+ * @returns The result of invoking the callable.
+ */
+template <
+    std::size_t Index, typename ShardsType, typename PointersType, typename LockerType,
+    typename CallableType>
+decltype(auto) lock_shards_in_order(
+    ShardsType& shards, PointersType& pointers, LockerType& locker, CallableType& callable)
+{
+    auto proxy = locker(shards[Index]);
+    pointers[Index] = &*proxy;
+
+    if constexpr (Index + 1 < std::tuple_size_v<PointersType>) {
+        return lock_shards_in_order<Index + 1>(shards, pointers, locker, callable);
+    } else {
+        return callable(std::as_const(pointers));
+    }
+}
+
+/**
+ * @brief Attempts to acquire a lock on every shard, in ascending index order, and then invokes the
+ * callable with pointers to the data of all shards.
+ *
+ * If any one of the shards fails to lock, all previously acquired locks are released.
+ *
+ * @returns If the callable returns void, true if all locks were acquired and false otherwise. If
+ * the callable returns something, an optional containing the result is returned instead.
+ */
+template <
+    std::size_t Index, typename ResultType, typename ShardsType, typename PointersType,
+    typename LockerType, typename CallableType>
+auto try_lock_shards_in_order(
+    ShardsType& shards, PointersType& pointers, LockerType& locker, CallableType& callable)
+    -> try_result_t<ResultType>
+{
+    auto proxy = locker(shards[Index]);
+    if (!proxy.is_locked()) {
+        return {};
+    }
+
+    pointers[Index] = &*proxy;
+
+    if constexpr (Index + 1 < std::tuple_size_v<PointersType>) {
+        return try_lock_shards_in_order<Index + 1, ResultType>(shards, pointers, locker, callable);
+    } else if constexpr (std::is_void_v<ResultType>) {
+        callable(std::as_const(pointers));
+        return true;
+    } else {
+        return callable(std::as_const(pointers));
+    }
+}
+
+template <typename DerivedType, typename DataType, std::size_t ShardCount, typename TagType>
+class sharded_guarded_impl
+{
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock shards guarded by a mutex that
+ * supports the Mutex concept.
+ */
+template <typename DerivedType, typename DataType, std::size_t ShardCount>
+class sharded_guarded_impl<DerivedType, DataType, ShardCount, detail::mutex_category::unique>
+{
+  public:
+    using shard_pointers = std::array<DataType*, ShardCount>;
+
+    /**
+     * @brief Locks the shard that the key maps onto, and then executes the passed in functor with
+     * the lock held.
+     *
+     * @param[in] key                 The key used to select the shard.
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename KeyType, typename CallableType>
+    decltype(auto) with_shard_for(const KeyType& key, CallableType&& callable)
+    {
+        auto proxy = static_cast<DerivedType*>(this)->shard_for(key).lock();
+        return callable(*proxy);
+    }
+
+    /**
+     * @brief Locks every shard, in a fixed order, and then executes the passed in functor with all
+     * locks held.
+     *
+     * @param[in] callable            A callable type that takes a `const shard_pointers&`.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> decltype(auto) with_all_shards_locked(CallableType&& callable)
+    {
+        shard_pointers pointers{};
+        auto locker = [](auto& shard) { return shard.lock(); };
+
+        return lock_shards_in_order<0>(
+            static_cast<DerivedType*>(this)->m_shards, pointers, locker, callable);
+    }
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock shards guarded by a mutex that
+ * supports the TimedMutex concept.
+ */
+template <typename DerivedType, typename DataType, std::size_t ShardCount>
+class sharded_guarded_impl<
+    DerivedType, DataType, ShardCount, detail::mutex_category::unique_and_timed>
+    : public sharded_guarded_impl<
+          DerivedType, DataType, ShardCount, detail::mutex_category::unique>
+{
+  public:
+    using typename sharded_guarded_impl<
+        DerivedType, DataType, ShardCount, detail::mutex_category::unique>::shard_pointers;
+
+    /**
+     * @brief Executes the functor only if the shard that the key maps onto can be locked before
+     * the timer expires.
+     *
+     * @param[in] key                 The key used to select the shard.
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            The functor to be invoked once the shard has been locked.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename KeyType, typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_shard_for(const KeyType& key, const ChronoType& timeout, CallableType&& callable)
+    {
+        return static_cast<DerivedType*>(this)->shard_for(key).try_with_lock_held_for(
+            timeout, std::forward<CallableType>(callable));
+    }
+
+    /**
+     * @brief Executes the functor only if every shard can be locked before the timer expires.
+     *
+     * The timeout applies to the acquisition of all locks combined, not to each lock individually.
+     *
+     * @param[in] timeout             The length of time to wait before abandoning the lock
+     *                                attempt.
+     * @param[in] callable            A callable type that takes a `const shard_pointers&`.
+     *
+     * @returns True if the functor returns void and all locks were acquired. If the functor returns
+     * something, an optional that is only engaged if all locks were acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_all_shards_locked_for(const ChronoType& timeout, CallableType&& callable)
+    {
+        using result_type = decltype(callable(std::declval<const shard_pointers&>()));
+
+        shard_pointers pointers{};
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        auto locker = [&](auto& shard) {
+            return shard.try_lock_for(deadline - std::chrono::steady_clock::now());
+        };
+
+        return try_lock_shards_in_order<0, result_type>(
+            static_cast<DerivedType*>(this)->m_shards, pointers, locker, callable);
+    }
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock shards guarded by a mutex that
+ * supports the SharedMutex concept.
+ */
+template <typename DerivedType, typename DataType, std::size_t ShardCount>
+class sharded_guarded_impl<DerivedType, DataType, ShardCount, detail::mutex_category::shared>
+{
+  public:
+    using shard_pointers = std::array<DataType*, ShardCount>;
+
+    using const_shard_pointers = std::array<const DataType*, ShardCount>;
+
+    /**
+     * @brief Grabs an exclusive lock on the shard that the key maps onto, and then executes the
+     * passed in functor with the lock held.
+     *
+     * @param[in] key                 The key used to select the shard.
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename KeyType, typename CallableType>
+    decltype(auto) with_write_shard_for(const KeyType& key, CallableType&& callable)
+    {
+        auto proxy = static_cast<DerivedType*>(this)->shard_for(key).write_lock();
+        return callable(*proxy);
+    }
+
+    /**
+     * @brief Grabs a shared lock on the shard that the key maps onto, and then executes the passed
+     * in functor with the lock held.
+     *
+     * @param[in] key                 The key used to select the shard.
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename KeyType, typename CallableType>
+    decltype(auto) with_read_shard_for(const KeyType& key, CallableType&& callable) const
+    {
+        const auto proxy = static_cast<const DerivedType*>(this)->shard_for(key).read_lock();
+        return callable(*proxy);
+    }
+
+    /**
+     * @brief Grabs an exclusive lock on every shard, in a fixed order, and then executes the
+     * passed in functor with all locks held.
+     *
+     * @param[in] callable            A callable type that takes a `const shard_pointers&`.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    decltype(auto) with_all_shards_write_locked(CallableType&& callable)
+    {
+        shard_pointers pointers{};
+        auto locker = [](auto& shard) { return shard.write_lock(); };
+
+        return lock_shards_in_order<0>(
+            static_cast<DerivedType*>(this)->m_shards, pointers, locker, callable);
+    }
+
+    /**
+     * @brief Grabs a shared lock on every shard, in a fixed order, and then executes the passed
+     * in functor with all locks held.
+     *
+     * @param[in] callable            A callable type that takes a `const const_shard_pointers&`.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType>
+    decltype(auto) with_all_shards_read_locked(CallableType&& callable) const
+    {
+        const_shard_pointers pointers{};
+        auto locker = [](const auto& shard) { return shard.read_lock(); };
+
+        return lock_shards_in_order<0>(
+            static_cast<const DerivedType*>(this)->m_shards, pointers, locker, callable);
+    }
+};
+
+/**
+ * @brief Specialization that provides the functionality to lock shards guarded by a mutex that
+ * supports the SharedTimedMutex concept.
+ */
+template <typename DerivedType, typename DataType, std::size_t ShardCount>
+class sharded_guarded_impl<
+    DerivedType, DataType, ShardCount, detail::mutex_category::shared_and_timed>
+    : public sharded_guarded_impl<
+          DerivedType, DataType, ShardCount, detail::mutex_category::shared>
+{
+    using base_type =
+        sharded_guarded_impl<DerivedType, DataType, ShardCount, detail::mutex_category::shared>;
+
+  public:
+    using typename base_type::const_shard_pointers;
+    using typename base_type::shard_pointers;
+
+    /**
+     * @brief Executes the functor only if an exclusive lock on the shard that the key maps onto
+     * can be acquired before the timer expires.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename KeyType, typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_write_shard_for(const KeyType& key, const ChronoType& timeout, CallableType&& callable)
+    {
+        return static_cast<DerivedType*>(this)->shard_for(key).try_with_write_lock_held_for(
+            timeout, std::forward<CallableType>(callable));
+    }
+
+    /**
+     * @brief Executes the functor only if a shared lock on the shard that the key maps onto can be
+     * acquired before the timer expires.
+     *
+     * @returns True if the functor returns void and the lock was acquired. If the functor returns
+     * something, an optional that is only engaged if the lock was acquired.
+     */
+    template <typename KeyType, typename ChronoType, typename CallableType>
+    [[nodiscard]] auto try_with_read_shard_for(
+        const KeyType& key, const ChronoType& timeout, CallableType&& callable) const
+    {
+        using result_type = decltype(callable(std::declval<const DataType&>()));
+
+        const auto proxy =
+            static_cast<const DerivedType*>(this)->shard_for(key).try_read_lock_for(timeout);
+
+        if (!proxy.is_locked()) {
+            return try_result_t<result_type>{};
+        }
+
+        if constexpr (std::is_void_v<result_type>) {
+            callable(*proxy);
+            return true;
+        } else {
+            return try_result_t<result_type>{ callable(*proxy) };
+        }
+    }
+
+    /**
+     * @brief Executes the functor only if an exclusive lock on every shard can be acquired before
+     * the timer expires.
+     *
+     * The timeout applies to the acquisition of all locks combined, not to each lock individually.
+     *
+     * @returns True if the functor returns void and all locks were acquired. If the functor returns
+     * something, an optional that is only engaged if all locks were acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_all_shards_write_locked_for(const ChronoType& timeout, CallableType&& callable)
+    {
+        using result_type = decltype(callable(std::declval<const shard_pointers&>()));
+
+        shard_pointers pointers{};
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        auto locker = [&](auto& shard) {
+            return shard.try_write_lock_for(deadline - std::chrono::steady_clock::now());
+        };
+
+        return try_lock_shards_in_order<0, result_type>(
+            static_cast<DerivedType*>(this)->m_shards, pointers, locker, callable);
+    }
+
+    /**
+     * @brief Executes the functor only if a shared lock on every shard can be acquired before the
+     * timer expires.
+     *
+     * The timeout applies to the acquisition of all locks combined, not to each lock individually.
+     *
+     * @returns True if the functor returns void and all locks were acquired. If the functor returns
+     * something, an optional that is only engaged if all locks were acquired.
+     */
+    template <typename ChronoType, typename CallableType>
+    [[nodiscard]] auto
+    try_with_all_shards_read_locked_for(const ChronoType& timeout, CallableType&& callable) const
+    {
+        using result_type = decltype(callable(std::declval<const const_shard_pointers&>()));
+
+        const_shard_pointers pointers{};
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        auto locker = [&](const auto& shard) {
+            return shard.try_read_lock_for(deadline - std::chrono::steady_clock::now());
+        };
+
+        return try_lock_shards_in_order<0, result_type>(
+            static_cast<const DerivedType*>(this)->m_shards, pointers, locker, callable);
+    }
+};
+
+/**
+ * @brief Specialization for shards guarded by a mutex that supports upgradeable locking, which is
+ * of no use across shards, so the shards are locked as though the mutex were a plain SharedMutex.
+ */
+template <typename DerivedType, typename DataType, std::size_t ShardCount>
+class sharded_guarded_impl<DerivedType, DataType, ShardCount, detail::mutex_category::upgrade>
+    : public sharded_guarded_impl<
+          DerivedType, DataType, ShardCount, detail::mutex_category::shared>
+{
+};
+} // namespace detail
+
+template <
+    typename DataType, std::size_t ShardCount, typename MutexType, typename KeyType,
+    typename HashType>
+class sharded_guarded;
+
+namespace detail
+{
+template <
+    typename DataType, std::size_t ShardCount, typename MutexType, typename KeyType,
+    typename HashType>
+using sharded_guarded_base = detail::sharded_guarded_impl<
+    sharded_guarded<DataType, ShardCount, MutexType, KeyType, HashType>, DataType, ShardCount,
+    typename detail::mutex_traits<MutexType>::category_type>;
+}
+
+/**
+ * @brief A collection of independently locked `mutex_guarded<...>` shards, where each key is
+ * routed to a shard by its hash.
+ *
+ * This relieves contention on a single, heavily used lock (guarding a hash map, for instance) by
+ * spreading the data over `ShardCount` locks. Operations that need to observe the whole table can
+ * lock every shard at once; the shards are always locked in the same order to avoid deadlocks.
+ *
+ * Keys are always converted to the `KeyType` before they're hashed by the `HashType`, so that a key
+ * maps onto the same shard no matter how it's passed in; a string literal, for instance, selects
+ * the same shard as the equivalent `std::string`. Both default to those of the data, which makes
+ * for a natural fit with associative containers.
+ *
+ * Just like `mutex_guarded<...>`, this class statically inherits the functionality appropriate to
+ * the specified mutex. See the various `detail::sharded_guarded_impl<...>` classes for further
+ * documentation.
+ */
+template <
+    typename DataType, std::size_t ShardCount, typename MutexType = std::mutex,
+    typename KeyType = typename DataType::key_type, typename HashType = std::hash<KeyType>>
+class sharded_guarded
+    : public detail::sharded_guarded_base<DataType, ShardCount, MutexType, KeyType, HashType>
+{
+    static_assert(ShardCount > 0, "A sharded_guarded<...> requires at least one shard.");
+
+    template <typename S, typename D, std::size_t N, typename T>
+    friend class detail::sharded_guarded_impl;
+
+  public:
+    using value_type = DataType;
+    using mutex_type = MutexType;
+    using key_type = KeyType;
+    using hasher = HashType;
+
+    // Each shard occupies its own cache line(s), so that locking one shard doesn't slow down
+    // access to its neighbours.
+    using shard_type = mutex_guarded<DataType, MutexType, adaptive_layout>;
+
+    static constexpr std::size_t shard_count = ShardCount;
+
+    /**
+     * @returns The index of the shard that the key maps onto.
+     */
+    static auto shard_index_for(const KeyType& key) -> std::size_t
+    {
+        const auto hash = HashType{}(key);
+        return static_cast<std::size_t>(detail::mix_hash(hash) % ShardCount);
+    }
+
+    /**
+     * @returns The shard that the key maps onto.
+     */
+    auto shard_for(const KeyType& key) -> shard_type&
+    {
+        return m_shards[shard_index_for(key)];
+    }
+
+    /**
+     * @returns The shard that the key maps onto.
+     */
+    auto shard_for(const KeyType& key) const -> const shard_type&
+    {
+        return m_shards[shard_index_for(key)];
+    }
+
+    /**
+     * @returns The shard at the specified index.
+     */
+    auto shard(std::size_t index) -> shard_type&
+    {
+        assert(index < ShardCount);
+        return m_shards[index];
+    }
+
+    /**
+     * @returns The shard at the specified index.
+     */
+    auto shard(std::size_t index) const -> const shard_type&
+    {
+        assert(index < ShardCount);
+        return m_shards[index];
+    }
+
+  private:
+    std::array<shard_type, ShardCount> m_shards;
+};
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "mutex_guarded.h"
+#include "rcu_guarded.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief A versioning policy that makes `mutex_guarded<...>` count the releases of write locks, so
+ * that it can tell whether the data may have changed since it was last observed. See
+ * `mutex_guarded<...>::update_optimistically(...)`.
+ *
+ * The version advances whenever a proxy that grants write access releases or downgrades its lock,
+ * regardless of whether the data was actually modified. Proxies that only grant read access,
+ * including those to a const guard, leave it alone.
+ */
+struct write_versioning
+{
+    static constexpr bool is_enabled = true;
+    static constexpr bool publishes_changes = false;
+
+    /**
+     * @brief The state that the policy adds to each guard.
+     */
+    class storage
+    {
+        template <typename B, typename L> friend class lock_proxy;
+
+      public:
+        /**
+         * @returns The number of write locks that have been released so far. The version can be
+         * read without holding the lock; if it is read with the lock held, it matches the data.
+         */
+        auto version() const noexcept -> std::uint64_t
+        {
+            return m_version.load(std::memory_order_acquire);
+        }
+
+      private:
+        /**
+         * @brief Only ever called by a proxy that holds an exclusive lock, so there is no need for
+         * an atomic read-modify-write.
+         */
+        void advance_version() noexcept
+        {
+            const auto current = m_version.load(std::memory_order_relaxed);
+            m_version.store(current + 1, std::memory_order_release);
+        }
+
+        std::atomic<std::uint64_t> m_version{ 0 };
+    };
+};
+
+/**
+ * @brief A `mutex_guarded<...>` that keeps a write version, which enables optimistic updates.
+ *
+ * Usage:
+ *
+ *     versioned_guarded<std::vector<order>> orders;
+ *
+ *     orders.update_optimistically(
+ *         [](const std::vector<order>& snapshot) { return build_index(snapshot); },
+ *         [&](std::vector<order>& data, order_index&& index) { apply(data, std::move(index)); });
+ */
+template <typename DataType, typename MutexType = std::mutex>
+using versioned_guarded = mutex_guarded<
+    DataType, MutexType, compact_layout, no_statistics, no_notification, write_versioning>;
+
+/**
+ * @brief A value derived from the data of a versioned guard, which is recomputed only once the
+ * guard's write version has advanced since the value was last computed. Created through
+ * `mutex_guarded<...>::derived(...)`.
+ *
+ * The cached value is published through an `rcu_guarded<...>`, so reading a current value never
+ * takes a lock, neither on the guarded data nor on the cache, and only writes to memory that is
+ * private to the calling thread (plus a reference count, in the case of `get()`). Once the data
+ * has changed, the first thread to ask for the value recomputes it, under a shared lock on the data
+ * if the mutex supports one, while other threads asking for it wait for the result instead of
+ * recomputing it themselves.
+ *
+ * Since recomputing locks the data and publishes the new value through RCU, the value must not be
+ * requested by a thread that holds a lock on the data, or from within an RCU read-side critical
+ * section, such as the functor passed to another view's `with_value(...)`.
+ *
+ * Usage:
+ *
+ *     versioned_guarded<std::vector<order>, std::shared_mutex> orders;
+ *
+ *     const auto by_price = orders.derived([](const std::vector<order>& data) {
+ *         return sorted_by_price(data);
+ *     });
+ *
+ *     const auto sorted = by_price.get(); // Recomputed only after a write to the orders.
+ */
+template <typename GuardType, typename FunctionType> class cached_view
+{
+  public:
+    using value_type = std::decay_t<
+        std::invoke_result_t<const FunctionType&, const typename GuardType::value_type&>>;
+
+    cached_view(const GuardType* guard, FunctionType function)
+        : m_guard{ guard }, m_function{ std::move(function) }
+    {
+    }
+
+    /**
+     * @returns The derived value, as of the latest write that was visible when the call was made.
+     * The value stays valid, and unchanged, for as long as the caller holds on to it, even if the
+     * view recomputes its value in the meantime.
+     */
+    auto get() const -> std::shared_ptr<const value_type>
+    {
+        {
+            const auto cache = m_cache.read_lock();
+            if (is_current(*cache)) {
+                return cache->value;
+            }
+        }
+
+        return refresh();
+    }
+
+    /**
+     * @brief Executes the passed in functor on the derived value, recomputing it first if
+     * necessary. Unlike `get()`, a current value is read without touching its reference count.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type should take its input parameter
+     *                                by const reference.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> auto with_value(CallableType&& callable) const
+    {
+        static_assert(
+            !std::is_reference_v<decltype(callable(std::declval<const value_type&>()))>,
+            "The value may be replaced once the functor returns, so it can't return a reference.");
+
+        {
+            const auto cache = m_cache.read_lock();
+            if (is_current(*cache)) {
+                return callable(std::as_const(*cache->value));
+            }
+        }
+
+        const auto value = refresh();
+        return callable(std::as_const(*value));
+    }
+
+  private:
+    struct entry
+    {
+        std::shared_ptr<const value_type> value;
+        std::uint64_t version = 0;
+    };
+
+    auto is_current(const entry& cache) const noexcept -> bool
+    {
+        return cache.value != nullptr && cache.version == m_guard->version();
+    }
+
+    /**
+     * @brief Recomputes the value, unless another thread has done so in the meantime, and
+     * publishes it to readers.
+     *
+     * @returns The current value.
+     */
+    auto refresh() const -> std::shared_ptr<const value_type>
+    {
+        const std::lock_guard<std::mutex> guard{ m_refresh_mutex };
+
+        // Another thread may have refreshed the value while this one waited for the lock.
+        {
+            const auto cache = m_cache.read_lock();
+            if (is_current(*cache)) {
+                return cache->value;
+            }
+        }
+
+        std::shared_ptr<const value_type> value;
+        std::uint64_t version = 0;
+
+        {
+            const detail::lock_all_proxy<const GuardType> data{ m_guard };
+
+            value = std::make_shared<const value_type>(m_function(*data));
+            version = m_guard->version();
+        }
+
+        m_cache.store(entry{ value, version });
+
+        return value;
+    }
+
+    const GuardType* m_guard;
+    FunctionType m_function;
+
+    mutable rcu_guarded<entry> m_cache;
+
+    // Only held while recomputing the value, never while reading it.
+    mutable std::mutex m_refresh_mutex;
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <type_traits>
+
+namespace detail
+{
+/**
+ * @brief Maps a locking policy onto the policy that reacquires the same kind of lock without a
+ * timeout, since a lock that was released for the sake of waiting on a condition variable has to
+ * be reacquired unconditionally.
+ */
+template <typename LockPolicyType> struct untimed_lock_policy
+{
+    using type = LockPolicyType;
+};
+
+template <> struct untimed_lock_policy<timed_unique_lock_policy>
+{
+    using type = unique_lock_policy;
+};
+
+template <> struct untimed_lock_policy<timed_shared_lock_policy>
+{
+    using type = shared_lock_policy;
+};
+
+/**
+ * @brief Adapts a mutex to the BasicLockable concept, using the given locking policy, so that a
+ * `std::condition_variable_any` can release and reacquire a lock of any kind.
+ */
+template <typename MutexType, typename LockPolicyType> class policy_lockable
+{
+  public:
+    policy_lockable(MutexType& mutex) : m_mutex{ mutex }
+    {
+    }
+
+    void lock()
+    {
+        untimed_lock_policy<LockPolicyType>::type::lock(m_mutex);
+    }
+
+    void unlock()
+    {
+        LockPolicyType::unlock(m_mutex);
+    }
+
+  private:
+    MutexType& m_mutex;
+};
+
+/**
+ * @brief Temporarily hands a lock on a `std::mutex` that is owned by a proxy to a
+ * `std::unique_lock<...>`, as required by `std::condition_variable`, and takes it back again on
+ * the way out, even if the predicate throws.
+ */
+class borrowed_unique_lock
+{
+  public:
+    borrowed_unique_lock(std::mutex& mutex) : m_lock{ mutex, std::adopt_lock }
+    {
+    }
+
+    ~borrowed_unique_lock() noexcept
+    {
+        m_lock.release();
+    }
+
+    borrowed_unique_lock(const borrowed_unique_lock&) = delete;
+    borrowed_unique_lock& operator=(const borrowed_unique_lock&) = delete;
+
+    auto get() noexcept -> std::unique_lock<std::mutex>&
+    {
+        return m_lock;
+    }
+
+  private:
+    std::unique_lock<std::mutex> m_lock;
+};
+} // namespace detail
+
+/**
+ * @brief A notification policy that adds a condition variable to `mutex_guarded<...>`, so that
+ * threads can block until the guarded data satisfies a predicate, rather than polling it. See
+ * `lock_proxy<...>::wait(...)` and `mutex_guarded<...>::modify_and_notify_one(...)`.
+ *
+ * Guards over a `std::mutex` use a `std::condition_variable`; all other guards, including those
+ * that wait while holding a shared lock, use a `std::condition_variable_any`.
+ *
+ * If statistics are recorded as well, the time spent waiting counts towards the hold time.
+ */
+struct condition_notification
+{
+    static constexpr bool is_enabled = true;
+
+    template <typename MutexType>
+    using condition_type = std::conditional_t<
+        std::is_same_v<MutexType, std::mutex>, std::condition_variable,
+        std::condition_variable_any>;
+
+    /**
+     * @brief The state that the policy adds to each guard.
+     */
+    template <typename MutexType> class storage
+    {
+      public:
+        /**
+         * @brief Wakes up one of the threads that are waiting on the guarded data. The data should
+         * have been modified under the lock beforehand; holding the lock while notifying is not
+         * required.
+         */
+        void notify_one() const noexcept
+        {
+            m_condition.notify_one();
+        }
+
+        /**
+         * @brief Wakes up all threads that are waiting on the guarded data.
+         */
+        void notify_all() const noexcept
+        {
+            m_condition.notify_all();
+        }
+
+        auto condition() const noexcept -> condition_type<MutexType>&
+        {
+            return m_condition;
+        }
+
+      private:
+        mutable condition_type<MutexType> m_condition;
+    };
+
+    /**
+     * @brief Blocks until the predicate holds. The lock must be held, in the mode described by the
+     * given lock policy.
+     */
+    template <
+        typename LockPolicyType, typename ConditionType, typename MutexType,
+        typename PredicateType>
+    static void wait(ConditionType& condition, MutexType& mutex, PredicateType&& predicate)
+    {
+        if constexpr (std::is_same_v<ConditionType, std::condition_variable>) {
+            detail::borrowed_unique_lock lock{ mutex };
+            condition.wait(lock.get(), predicate);
+        } else {
+            detail::policy_lockable<MutexType, LockPolicyType> lock{ mutex };
+            condition.wait(lock, predicate);
+        }
+    }
+
+    /**
+     * @brief Blocks until the predicate holds, or until the deadline passes. The lock must be
+     * held, in the mode described by the given lock policy.
+     *
+     * @returns The result of the final evaluation of the predicate.
+     */
+    template <
+        typename LockPolicyType, typename ConditionType, typename MutexType,
+        typename TimePointType, typename PredicateType>
+    static auto wait_until(
+        ConditionType& condition, MutexType& mutex, const TimePointType& deadline,
+        PredicateType&& predicate) -> bool
+    {
+        if constexpr (std::is_same_v<ConditionType, std::condition_variable>) {
+            detail::borrowed_unique_lock lock{ mutex };
+            return condition.wait_until(lock.get(), deadline, predicate);
+        } else {
+            detail::policy_lockable<MutexType, LockPolicyType> lock{ mutex };
+            return condition.wait_until(lock, deadline, predicate);
+        }
+    }
+};
+
+/**
+ * @brief A `mutex_guarded<...>` whose proxies can wait for the guarded data to satisfy a
+ * predicate.
+ *
+ * Usage:
+ *
+ *     waitable_guarded<std::deque<job>> queue;
+ *
+ *     // Producer:
+ *     queue.modify_and_notify_one([&](std::deque<job>& jobs) {
+ *         jobs.push_back(std::move(next));
+ *         return true;
+ *     });
+ *
+ *     // Consumer:
+ *     auto jobs = queue.lock();
+ *     jobs.wait([](const std::deque<job>& jobs) { return !jobs.empty(); });
+ */
+template <typename DataType, typename MutexType = std::mutex>
+using waitable_guarded =
+    mutex_guarded<DataType, MutexType, compact_layout, no_statistics, condition_notification>;
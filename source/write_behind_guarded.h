@@ -0,0 +1,314 @@
+#pragma once
+
+#include "mutex_guarded.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace detail
+{
+/**
+ * @brief A mutation that has been posted to a `write_behind_guarded<...>`, and that is waiting in
+ * its queue to be applied.
+ */
+template <typename DataType> class posted_mutation
+{
+  public:
+    using function_type = void (*)(posted_mutation*, DataType&) noexcept;
+
+    explicit posted_mutation(function_type function) noexcept : m_function{ function }
+    {
+    }
+
+    posted_mutation(const posted_mutation&) = delete;
+    posted_mutation& operator=(const posted_mutation&) = delete;
+
+    /**
+     * @brief Applies the mutation to the data, and then destroys the mutation.
+     */
+    void apply_and_destroy(DataType& data) noexcept
+    {
+        m_function(this, data);
+    }
+
+    std::atomic<posted_mutation*> next{ nullptr };
+
+  private:
+    function_type m_function;
+};
+
+/**
+ * @brief A heap-allocated mutation that owns the callable that was posted.
+ */
+template <typename DataType, typename CallableType>
+class posted_callable : public posted_mutation<DataType>
+{
+  public:
+    template <typename ArgumentType>
+    explicit posted_callable(ArgumentType&& callable)
+        : posted_mutation<DataType>{ &apply_and_destroy },
+          m_callable{ std::forward<ArgumentType>(callable) }
+    {
+    }
+
+  private:
+    static void apply_and_destroy(posted_mutation<DataType>* mutation, DataType& data) noexcept
+    {
+        auto* const self = static_cast<posted_callable*>(mutation);
+
+        self->m_callable(data);
+        delete self;
+    }
+
+    CallableType m_callable;
+};
+
+/**
+ * @brief An intrusive, unbounded, lock-free multi-producer, single-consumer queue, as described
+ * by Dmitry Vyukov. Pushing is wait-free; popping must be serialized by the caller.
+ */
+template <typename DataType> class mutation_queue
+{
+  public:
+    using node_type = posted_mutation<DataType>;
+
+    mutation_queue() = default;
+
+    mutation_queue(const mutation_queue&) = delete;
+    mutation_queue& operator=(const mutation_queue&) = delete;
+
+    void push(node_type* node) noexcept
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+
+        auto* const previous = m_head.exchange(node, std::memory_order_acq_rel);
+
+        // Between the exchange and this store, the consumer can't see past the previous node.
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @returns The oldest node, or null if the queue is empty, or if the oldest node is still
+     * being linked in by a producer.
+     */
+    auto pop() noexcept -> node_type*
+    {
+        auto* tail = m_tail;
+        auto* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (!next) {
+                return nullptr;
+            }
+
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        // The tail is the last node, so re-insert the stub behind it, so that it can be popped.
+        push(&m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @returns True if nothing has been pushed since the queue was last emptied. Since producers
+     * may push at any time, this is only a hint; it can be called without serializing against the
+     * consumer.
+     */
+    auto is_empty() const noexcept -> bool
+    {
+        return m_head.load(std::memory_order_acquire) == &m_stub;
+    }
+
+  private:
+    node_type m_stub{ nullptr };
+
+    alignas(cache_line_size) std::atomic<node_type*> m_head{ &m_stub };
+    alignas(cache_line_size) node_type* m_tail{ &m_stub };
+};
+} // namespace detail
+
+/**
+ * @brief A wrapper around data that is guarded by a mutex, and that additionally accepts
+ * fire-and-forget mutations, which are applied in batches.
+ *
+ * `post_with_lock_held(...)` appends the mutation to a lock-free queue and returns right away,
+ * without ever touching the mutex. Queued mutations are applied, in the order in which they were
+ * posted, by whichever thread next acquires the lock through `with_lock_held(...)` or `flush()`,
+ * or by an optional background thread (see `start_draining(...)`). Since every drain empties the
+ * whole queue under a single acquisition, a burst of posts costs only one lock hand-off.
+ *
+ * Until it is drained, the queue grows without bound, so a guard that mostly receives posts should
+ * either be flushed periodically or have a background thread drain it.
+ */
+template <typename DataType, typename MutexType = std::mutex> class write_behind_guarded
+{
+    static_assert(
+        detail::traits::is_mutex<MutexType>::value, "The MutexType must support the Mutex concept");
+
+  public:
+    using value_type = DataType;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using mutex_type = MutexType;
+
+    write_behind_guarded() = default;
+
+    write_behind_guarded(DataType data) : m_data{ std::move(data) }
+    {
+    }
+
+    write_behind_guarded(const write_behind_guarded&) = delete;
+    write_behind_guarded& operator=(const write_behind_guarded&) = delete;
+
+    /**
+     * @brief Stops the background thread, if any, and applies whatever is left in the queue.
+     */
+    ~write_behind_guarded() noexcept
+    {
+        stop_draining();
+
+        // Unlike `flush()`, this doesn't post a marker, so that it can't fail to allocate; no one
+        // else may post to a guard that is being destroyed, so the queue only has to be emptied.
+        const std::lock_guard<MutexType> guard{ m_mutex };
+        do {
+            drain();
+        } while (!m_queue.is_empty());
+    }
+
+    /**
+     * @brief Grabs the lock, applies all queued mutations, and then executes the passed in functor
+     * with the lock held.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference; avoid taking input by value.
+     *
+     * @returns The result of invoking the functor.
+     */
+    template <typename CallableType> decltype(auto) with_lock_held(CallableType&& callable)
+    {
+        const std::lock_guard<MutexType> guard{ m_mutex };
+        drain();
+
+        return callable(m_data);
+    }
+
+    /**
+     * @brief Enqueues the passed in functor, to be executed with the lock held at some later point,
+     * and returns without waiting for it. Mutations are applied in the order in which they were
+     * posted.
+     *
+     * @param[in] callable            A callable type like a lambda, std::function, etc.
+     *                                This callable type must take its input parameter
+     *                                by reference, and it is copied or moved into the queue, so
+     *                                anything that it captures by reference has to outlive it.
+     *                                It must not throw, since there is no one to report to.
+     */
+    template <typename CallableType> void post_with_lock_held(CallableType&& callable)
+    {
+        using node_type = detail::posted_callable<DataType, std::decay_t<CallableType>>;
+
+        m_queue.push(new node_type{ std::forward<CallableType>(callable) });
+    }
+
+    /**
+     * @brief Blocks until every mutation that was posted before the call has been applied. Posts a
+     * marker to the queue in order to do so, which may throw `std::bad_alloc`.
+     */
+    void flush()
+    {
+        std::atomic<bool> was_reached{ false };
+        post_with_lock_held([&](DataType&) noexcept {
+            was_reached.store(true, std::memory_order_release);
+        });
+
+        while (true) {
+            {
+                const std::lock_guard<MutexType> guard{ m_mutex };
+                drain();
+            }
+
+            if (was_reached.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            // A producer is still linking in a mutation ahead of ours, so give it a moment.
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Starts a background thread that drains the queue at the given interval. At most one
+     * such thread can run at a time.
+     */
+    template <typename ChronoType> void start_draining(const ChronoType& interval)
+    {
+        assert(!m_drainer.joinable());
+
+        m_should_stop_draining.store(false, std::memory_order_relaxed);
+        m_drainer = std::thread{ [this, interval] {
+            while (!m_should_stop_draining.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(interval);
+
+                if (!m_queue.is_empty()) {
+                    const std::lock_guard<MutexType> guard{ m_mutex };
+                    drain();
+                }
+            }
+        } };
+    }
+
+    /**
+     * @brief Stops the background thread, if one is running. Mutations that are still queued are
+     * left for the next lock holder.
+     */
+    void stop_draining() noexcept
+    {
+        if (m_drainer.joinable()) {
+            m_should_stop_draining.store(true, std::memory_order_relaxed);
+            m_drainer.join();
+        }
+    }
+
+  private:
+    /**
+     * @brief Applies all queued mutations. The mutex must be held.
+     */
+    void drain() noexcept
+    {
+        while (auto* const mutation = m_queue.pop()) {
+            mutation->apply_and_destroy(m_data);
+        }
+    }
+
+    detail::mutation_queue<DataType> m_queue;
+
+    std::thread m_drainer;
+    std::atomic<bool> m_should_stop_draining{ false };
+
+    alignas(detail::cache_line_size) MutexType m_mutex;
+    DataType m_data;
+};
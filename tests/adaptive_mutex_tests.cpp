@@ -0,0 +1,227 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <adaptive_mutex.h>
+
+namespace
+{
+/**
+ * @brief Increments the guarded counter from several threads at once, and returns the final count.
+ */
+template <typename GuardedType> auto increment_concurrently(GuardedType& data) -> int
+{
+    constexpr int thread_count = 4;
+    constexpr int increments = 10'000;
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&] {
+            for (int increment = 0; increment < increments; ++increment) {
+                ++*data.lock();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return *data.lock();
+}
+} // namespace
+
+TEST_CASE("Adaptive Spinner")
+{
+    detail::adaptive_spinner spinner;
+
+    std::atomic<bool> is_locked{ true };
+    std::atomic<int> attempts{ 0 };
+
+    const auto try_acquire = [&] {
+        ++attempts;
+        auto expected = false;
+        return is_locked.compare_exchange_strong(expected, true);
+    };
+
+    SECTION("A lock that's held for a long time shrinks the spin phase")
+    {
+        auto previous = spinner.estimate();
+        for (int spin = 0; spin < 4; ++spin) {
+            REQUIRE(spinner.spin(try_acquire) == false);
+            REQUIRE(spinner.estimate() < previous);
+
+            previous = spinner.estimate();
+        }
+
+        is_locked = false;
+
+        REQUIRE(spinner.spin(try_acquire) == true);
+    }
+
+    SECTION("Spinning stops once the deadline has passed")
+    {
+        const auto estimate = spinner.estimate();
+        const auto deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds{ 1 };
+
+        REQUIRE(spinner.spin(try_acquire, &deadline) == false);
+        REQUIRE(attempts == 1);
+        REQUIRE(spinner.estimate() == estimate);
+    }
+}
+
+TEST_CASE("Adaptive Mutex Traits")
+{
+    SECTION("Adaptive mutexes are detected as the right mutex category")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<adaptive_mutex>,
+                       detail::mutex_category::unique>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<adaptive_timed_mutex>,
+                       detail::mutex_category::unique_and_timed>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<adaptive_shared_timed_mutex>,
+                       detail::mutex_category::shared_and_timed>);
+    }
+
+    SECTION("Adaptive mutexes are small")
+    {
+        STATIC_REQUIRE(sizeof(adaptive_mutex) <= 8);
+        STATIC_REQUIRE(sizeof(adaptive_shared_timed_mutex) <= 8);
+    }
+}
+
+TEST_CASE("Mutex Guard using an adaptive_mutex")
+{
+    mutex_guarded<int, adaptive_mutex> data{ 0 };
+
+    SECTION("Writing data using a lambda")
+    {
+        data.with_lock_held([](int& value) noexcept { value = 42; });
+        REQUIRE(*data.lock() == 42);
+    }
+
+    SECTION("Concurrent increments are not lost")
+    {
+        REQUIRE(increment_concurrently(data) == 40'000);
+    }
+}
+
+TEST_CASE("Mutex Guard using an adaptive_timed_mutex")
+{
+    mutex_guarded<int, adaptive_timed_mutex> data{ 0 };
+
+    constexpr auto timeout = std::chrono::milliseconds{ 10 };
+
+    SECTION("Locking an uncontended mutex succeeds")
+    {
+        REQUIRE(data.try_lock_for(timeout).is_locked());
+    }
+
+    SECTION("Locking a contended mutex times out")
+    {
+        const auto proxy = data.lock();
+
+        auto future = std::async(std::launch::async, [&] {
+            const auto start = std::chrono::steady_clock::now();
+            const auto was_locked = data.try_lock_for(timeout).is_locked();
+            return std::make_pair(was_locked, std::chrono::steady_clock::now() - start);
+        });
+
+        const auto [was_locked, elapsed] = future.get();
+
+        REQUIRE(was_locked == false);
+        REQUIRE(elapsed >= timeout);
+    }
+
+    SECTION("A parked waiter acquires the mutex once it is released")
+    {
+        auto proxy = std::make_unique<decltype(data.lock())>(data.lock());
+
+        auto future = std::async(std::launch::async, [&] {
+            return data.try_lock_for(std::chrono::seconds{ 10 }).is_locked();
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        proxy.reset();
+
+        REQUIRE(future.get() == true);
+    }
+
+    SECTION("Concurrent increments are not lost")
+    {
+        REQUIRE(increment_concurrently(data) == 40'000);
+    }
+}
+
+TEST_CASE("Mutex Guard using an adaptive_shared_timed_mutex")
+{
+    mutex_guarded<int, adaptive_shared_timed_mutex> data{ 0 };
+
+    constexpr auto timeout = std::chrono::milliseconds{ 10 };
+
+    SECTION("Multiple readers can hold the lock at once")
+    {
+        const auto first = data.read_lock();
+        const auto second = data.try_read_lock_for(timeout);
+
+        REQUIRE(second.is_locked());
+    }
+
+    SECTION("Writers are excluded by readers")
+    {
+        const auto proxy = data.read_lock();
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return data.try_write_lock_for(timeout).is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+    }
+
+    SECTION("A writer that times out doesn't block subsequent readers")
+    {
+        const auto proxy = data.read_lock();
+
+        std::async(std::launch::async, [&] { return data.try_write_lock_for(timeout).is_locked(); })
+            .wait();
+
+        REQUIRE(data.try_read_lock_for(timeout).is_locked());
+    }
+
+    SECTION("Concurrent readers and writers")
+    {
+        std::atomic<bool> torn_read{ false };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int iteration = 0; iteration < 5'000; ++iteration) {
+                    if (thread % 2 == 0) {
+                        auto proxy = data.write_lock();
+                        ++*proxy;
+                        ++*proxy;
+                    } else if (*data.read_lock() % 2 != 0) {
+                        torn_read = true;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(torn_read == false);
+        REQUIRE(*data.read_lock() == 20'000);
+    }
+}
@@ -0,0 +1,220 @@
+#include <catch2/catch.hpp>
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <async_mutex.h>
+
+namespace
+{
+/**
+ * @brief A coroutine that starts right away, and that cleans up after itself once it completes.
+ */
+struct detached_task
+{
+    struct promise_type
+    {
+        auto get_return_object() noexcept -> detached_task
+        {
+            return {};
+        }
+
+        auto initial_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+/**
+ * @brief An executor that holds on to the coroutines that it is asked to resume, until the test
+ * resumes them explicitly.
+ */
+struct manual_executor
+{
+    std::deque<std::coroutine_handle<>>* queue;
+
+    void schedule(std::coroutine_handle<> coroutine) const
+    {
+        queue->push_back(coroutine);
+    }
+};
+
+void run_all(std::deque<std::coroutine_handle<>>& queue)
+{
+    while (!queue.empty()) {
+        const auto coroutine = queue.front();
+        queue.pop_front();
+        coroutine.resume();
+    }
+}
+
+using exclusive_guard = mutex_guarded<std::string, async_mutex>;
+using shared_guard = mutex_guarded<std::string, async_shared_mutex>;
+
+auto append(exclusive_guard& data, std::string suffix) -> detached_task
+{
+    auto proxy = co_await data.async_lock();
+    *proxy += suffix;
+}
+
+auto append_via(exclusive_guard& data, std::string suffix, manual_executor executor)
+    -> detached_task
+{
+    auto proxy = co_await data.async_lock(executor);
+    *proxy += suffix;
+}
+
+auto append_exclusively(shared_guard& data, std::string suffix) -> detached_task
+{
+    auto proxy = co_await data.async_write_lock();
+    *proxy += suffix;
+}
+
+auto read_into(const shared_guard& data, std::vector<std::string>& reads) -> detached_task
+{
+    const auto proxy = co_await data.async_read_lock();
+    reads.push_back(*proxy);
+}
+
+auto increment(mutex_guarded<std::uint64_t, async_mutex>& counter, int count) -> detached_task
+{
+    for (int iteration = 0; iteration < count; ++iteration) {
+        auto proxy = co_await counter.async_lock();
+        ++*proxy;
+    }
+}
+} // namespace
+
+TEST_CASE("Asynchronous Mutex")
+{
+    exclusive_guard data{ "a" };
+
+    SECTION("Awaiting a free mutex completes right away")
+    {
+        append(data, "b");
+
+        REQUIRE(data.with_lock_held([](const std::string& value) { return value; }) == "ab");
+    }
+
+    SECTION("Awaiting a held mutex suspends the coroutine until the lock is released")
+    {
+        std::optional<exclusive_guard::unique_lock_proxy> proxy;
+        proxy.emplace(&data);
+
+        append(data, "b");
+        append(data, "c");
+
+        REQUIRE(**proxy == "a");
+
+        // Releasing the lock resumes the first coroutine on this thread, which in turn hands the
+        // lock to the second.
+        proxy.reset();
+
+        REQUIRE(data.with_lock_held([](const std::string& value) { return value; }) == "abc");
+    }
+
+    SECTION("Waiting coroutines are resumed through their executor")
+    {
+        std::deque<std::coroutine_handle<>> queue;
+
+        std::optional<exclusive_guard::unique_lock_proxy> proxy;
+        proxy.emplace(&data);
+
+        append_via(data, "b", manual_executor{ &queue });
+        proxy.reset();
+
+        REQUIRE(queue.size() == 1);
+
+        // The lock was handed to the coroutine, even though it hasn't run yet:
+        REQUIRE(data.try_lock().is_locked() == false);
+
+        run_all(queue);
+
+        REQUIRE(data.with_lock_held([](const std::string& value) { return value; }) == "ab");
+    }
+
+    SECTION("Coroutines and threads can contend for the same guard")
+    {
+        mutex_guarded<std::uint64_t, async_mutex> counter{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] {
+                if (thread % 2 == 0) {
+                    increment(counter, 10'000);
+                } else {
+                    for (int iteration = 0; iteration < 10'000; ++iteration) {
+                        counter.with_lock_held([](std::uint64_t& value) noexcept { ++value; });
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // Suspended coroutines are resumed inline by whichever thread releases the lock, so all of
+        // them have completed by the time that the threads are done.
+        REQUIRE(counter.with_lock_held([](const std::uint64_t& value) { return value; }) == 40'000);
+    }
+}
+
+TEST_CASE("Asynchronous Shared Mutex")
+{
+    shared_guard data{ "a" };
+    std::vector<std::string> reads;
+
+    SECTION("Readers that queued up together are granted the lock together")
+    {
+        std::optional<shared_guard::unique_lock_proxy> proxy;
+        proxy.emplace(&data);
+
+        read_into(data, reads);
+        read_into(data, reads);
+        append_exclusively(data, "b");
+        read_into(data, reads);
+
+        REQUIRE(reads.empty());
+
+        proxy.reset();
+
+        REQUIRE(reads == std::vector<std::string>{ "a", "a", "ab" });
+    }
+
+    SECTION("New readers queue up behind a waiting writer")
+    {
+        std::optional<shared_guard::shared_lock_proxy> proxy;
+        proxy.emplace(&data);
+
+        append_exclusively(data, "b");
+
+        REQUIRE(data.try_read_lock().is_locked() == false);
+
+        read_into(data, reads);
+        proxy.reset();
+
+        REQUIRE(reads == std::vector<std::string>{ "ab" });
+    }
+}
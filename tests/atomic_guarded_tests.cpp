@@ -0,0 +1,163 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <atomic_guarded.h>
+
+namespace
+{
+struct small_pair
+{
+    std::int32_t first;
+    std::int32_t second;
+};
+
+struct wide_pair
+{
+    std::uint64_t first;
+    std::uint64_t second;
+};
+} // namespace
+
+TEST_CASE("Atomic Guard")
+{
+    atomic_guarded<small_pair> data{ small_pair{ 1, 2 } };
+
+    SECTION("Reading data using a lambda that returns something")
+    {
+        const auto sum =
+            data.with_lock_held([](const small_pair& pair) { return pair.first + pair.second; });
+
+        REQUIRE(sum == 3);
+    }
+
+    SECTION("Modifying data using a lambda that returns something")
+    {
+        const auto previous = data.with_lock_held([](small_pair& pair) {
+            const auto first = pair.first;
+            pair.first = pair.second;
+            pair.second = first;
+            return first;
+        });
+
+        REQUIRE(previous == 1);
+        REQUIRE(data.read().first == 2);
+        REQUIRE(data.read().second == 1);
+    }
+
+    SECTION("Modifying data using a lambda that returns nothing")
+    {
+        data.with_write_lock_held([](small_pair& pair) noexcept { pair.second = 5; });
+
+        REQUIRE(data.with_read_lock_held([](const small_pair& pair) { return pair.second; }) == 5);
+    }
+
+    SECTION("Modifying data using a generic lambda")
+    {
+        data.with_lock_held([](auto& pair) noexcept { ++pair.first; });
+
+        REQUIRE(data.read().first == 2);
+    }
+
+    SECTION("Replacing the data")
+    {
+        data.write(small_pair{ 3, 4 });
+
+        const auto previous = data.exchange(small_pair{ 5, 6 });
+
+        REQUIRE(previous.first == 3);
+        REQUIRE(data.read().first == 5);
+    }
+}
+
+TEST_CASE("Atomic Guard with Contention")
+{
+    atomic_guarded<std::uint64_t> counter{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&] {
+            for (int iteration = 0; iteration < 10'000; ++iteration) {
+                counter.with_lock_held([](std::uint64_t& value) noexcept { ++value; });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(counter.read() == 40'000);
+}
+
+#if MUTEX_GUARDED_HAS_DOUBLE_WORD_CAS
+TEST_CASE("Atomic Guard with a Double-Word Compare-and-Swap")
+{
+    STATIC_REQUIRE(is_atomic_guardable_v<wide_pair>);
+
+    atomic_guarded<wide_pair> data{ wide_pair{ 0, 0 } };
+
+    SECTION("Concurrent modifications update both words together")
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 10'000; ++iteration) {
+                    data.with_lock_held([](wide_pair& pair) noexcept {
+                        ++pair.first;
+                        pair.second += 2;
+                    });
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const auto pair = data.read();
+
+        REQUIRE(pair.first == 40'000);
+        REQUIRE(pair.second == 80'000);
+    }
+
+    SECTION("Replacing the data")
+    {
+        data.write(wide_pair{ 1, 2 });
+
+        const auto previous = data.exchange(wide_pair{ 3, 4 });
+
+        REQUIRE(previous.first == 1);
+        REQUIRE(previous.second == 2);
+        REQUIRE(data.read().first == 3);
+        REQUIRE(data.read().second == 4);
+    }
+}
+#endif
+
+TEST_CASE("Selecting a Lock-Free Guard")
+{
+    STATIC_REQUIRE(is_atomic_guardable_v<std::uint64_t>);
+    STATIC_REQUIRE(is_atomic_guardable_v<double>);
+    STATIC_REQUIRE(is_atomic_guardable_v<small_pair>);
+    STATIC_REQUIRE_FALSE(is_atomic_guardable_v<std::string>);
+
+    STATIC_REQUIRE(
+        std::is_same_v<maybe_atomic_guarded<std::uint64_t>, atomic_guarded<std::uint64_t>>);
+
+    STATIC_REQUIRE(std::is_same_v<maybe_atomic_guarded<std::string>, mutex_guarded<std::string>>);
+
+    maybe_atomic_guarded<double> value{ 1.5 };
+    value.with_lock_held([](double& number) noexcept { number *= 2; });
+
+    REQUIRE(value.with_lock_held([](const double& number) { return number; }) == 3.0);
+
+    maybe_atomic_guarded<std::uint64_t> counter{ 1 };
+    counter.with_lock_held([](auto& number) noexcept { ++number; });
+
+    REQUIRE(counter.with_lock_held([](const auto& number) { return number; }) == 2);
+}
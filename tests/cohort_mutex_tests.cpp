@@ -0,0 +1,198 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <cohort_mutex.h>
+
+namespace
+{
+/**
+ * @brief Simulates the given topology for the mutexes that are constructed during the lifetime of
+ * this object.
+ */
+class simulated_topology
+{
+  public:
+    explicit simulated_topology(std::vector<std::size_t> node_of_cpu)
+    {
+        numa_topology::use_for_new_mutexes(numa_topology{ std::move(node_of_cpu) });
+    }
+
+    ~simulated_topology()
+    {
+        numa_topology::use_for_new_mutexes(numa_topology::from_sysfs());
+    }
+};
+
+/**
+ * @brief Holds the lock on node zero while the given waiters, each pinned to a node, queue up one
+ * after the other, and then records the order in which the waiters acquire the lock.
+ */
+template <typename MutexType> auto acquisition_order(const std::vector<std::size_t>& waiters)
+{
+    MutexType mutex;
+    std::vector<std::size_t> order;
+    std::vector<std::thread> threads;
+
+    {
+        const scoped_numa_node node{ 0 };
+        mutex.lock();
+    }
+
+    for (std::size_t waiter = 0; waiter < waiters.size(); ++waiter) {
+        const auto node = waiters[waiter];
+        const auto local_tickets = detail::cohort_inspector::local_tickets(mutex, node);
+        const auto global_tail = detail::cohort_inspector::global_tail(mutex);
+
+        threads.emplace_back([&, waiter] {
+            const scoped_numa_node pinned{ waiters[waiter] };
+            const std::lock_guard<MutexType> guard{ mutex };
+            order.push_back(waiter);
+        });
+
+        // Wait for the waiter to join the queue of its node before the next one arrives. The
+        // first waiter on a node that doesn't hold the global lock goes on to queue up for it.
+        while (detail::cohort_inspector::local_tickets(mutex, node) == local_tickets) {
+            std::this_thread::yield();
+        }
+
+        if (node != 0 && local_tickets == 0) {
+            while (detail::cohort_inspector::global_tail(mutex) == global_tail) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    {
+        const scoped_numa_node node{ 0 };
+        mutex.unlock();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return order;
+}
+} // namespace
+
+TEST_CASE("NUMA Topology")
+{
+    SECTION("Index lists are parsed in the kernel's format")
+    {
+        REQUIRE(detail::parse_index_list("0") == std::vector<std::size_t>{ 0 });
+        REQUIRE(
+            detail::parse_index_list("0-2,5,7-8\n") ==
+            std::vector<std::size_t>{ 0, 1, 2, 5, 7, 8 });
+        REQUIRE(detail::parse_index_list("").empty());
+        REQUIRE(detail::parse_index_list("x").empty());
+    }
+
+    SECTION("The topology is read from a sysfs-like directory")
+    {
+        const auto root = std::filesystem::temp_directory_path() / "mutex_guarded_numa_test";
+        std::filesystem::create_directories(root / "node0");
+        std::filesystem::create_directories(root / "node2");
+
+        std::ofstream{ root / "online" } << "0,2\n";
+        std::ofstream{ root / "node0" / "cpulist" } << "0-1,4\n";
+        std::ofstream{ root / "node2" / "cpulist" } << "2-3\n";
+
+        const auto topology = numa_topology::from_sysfs(root.string());
+        std::filesystem::remove_all(root);
+
+        REQUIRE(topology.node_count() == 2);
+        REQUIRE(topology.node_of_cpu(0) == 0);
+        REQUIRE(topology.node_of_cpu(3) == 1);
+        REQUIRE(topology.node_of_cpu(4) == 0);
+    }
+
+    SECTION("An unreadable directory yields a single node")
+    {
+        const auto topology = numa_topology::from_sysfs("/nonexistent");
+
+        REQUIRE(topology.node_count() == 1);
+        REQUIRE(topology.current_node() == 0);
+    }
+
+    SECTION("Threads can be pinned to a simulated node")
+    {
+        const numa_topology topology{ { 0, 1 } };
+
+        const scoped_numa_node node{ 1 };
+        REQUIRE(topology.current_node() == 1);
+    }
+}
+
+TEST_CASE("Mutex Guard using a cohort_mutex")
+{
+    const simulated_topology topology{ { 0, 1 } };
+
+    SECTION("The cohort mutex is detected as an exclusive mutex")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<cohort_mutex>,
+                       detail::mutex_category::unique>);
+
+        REQUIRE(cohort_mutex{}.node_count() == 2);
+    }
+
+    SECTION("Concurrent increments from different nodes are not lost")
+    {
+        mutex_guarded<int, cohort_mutex> data{ 0 };
+
+        std::vector<std::thread> threads;
+        for (std::size_t thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&, thread] {
+                const scoped_numa_node node{ thread % 2 };
+
+                for (int increment = 0; increment < 10'000; ++increment) {
+                    data.with_lock_held([](int& value) noexcept { ++value; });
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*data.lock() == 80'000);
+    }
+
+    SECTION("The lock is passed to waiters on the same node first")
+    {
+        const auto order = acquisition_order<basic_cohort_mutex<64>>({ 1, 0, 0 });
+
+        REQUIRE(order == std::vector<std::size_t>{ 1, 2, 0 });
+    }
+
+    SECTION("Other nodes get their turn once the hand-off limit is reached")
+    {
+        const auto order = acquisition_order<basic_cohort_mutex<1>>({ 1, 0, 0 });
+
+        REQUIRE(order == std::vector<std::size_t>{ 1, 0, 2 });
+    }
+
+    SECTION("A held mutex can't be acquired by trying, from either node")
+    {
+        mutex_guarded<int, cohort_mutex> data{ 0 };
+
+        const auto proxy = data.lock();
+
+        for (std::size_t node = 0; node < 2; ++node) {
+            const auto was_locked = std::async(std::launch::async, [&] {
+                                        const scoped_numa_node pinned{ node };
+                                        return data.try_lock().is_locked();
+                                    }).get();
+
+            REQUIRE(was_locked == false);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <combining_guarded.h>
+
+TEST_CASE("Combining Guard")
+{
+    combining_guarded<std::map<std::string, std::int64_t>> counters;
+
+    SECTION("Modifying data using a lambda, returning nothing")
+    {
+        counters.with_lock_held([](std::map<std::string, std::int64_t>& map) { ++map["a"]; });
+
+        const auto count = counters.with_lock_held(
+            [](const std::map<std::string, std::int64_t>& map) { return map.at("a"); });
+
+        REQUIRE(count == 1);
+    }
+
+    SECTION("Results are returned to each submitter")
+    {
+        std::vector<std::thread> threads;
+        std::vector<std::int64_t> mismatches(4, 0);
+
+        for (std::size_t thread = 0; thread < mismatches.size(); ++thread) {
+            threads.emplace_back([&, thread] {
+                const auto key = std::to_string(thread);
+
+                for (std::int64_t iteration = 1; iteration <= 10'000; ++iteration) {
+                    const auto count = counters.with_lock_held(
+                        [&](std::map<std::string, std::int64_t>& map) { return ++map[key]; });
+
+                    mismatches[thread] += count != iteration;
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (std::size_t thread = 0; thread < mismatches.size(); ++thread) {
+            REQUIRE(mismatches[thread] == 0);
+        }
+    }
+
+    SECTION("Exceptions are rethrown on the submitting thread")
+    {
+        const auto throwing = [](std::map<std::string, std::int64_t>& map) -> std::int64_t {
+            return map.at("missing");
+        };
+
+        REQUIRE_THROWS_AS(counters.with_lock_held(throwing), std::out_of_range);
+
+        counters.with_lock_held([](std::map<std::string, std::int64_t>& map) { ++map["a"]; });
+    }
+}
+
+TEST_CASE("Combining Guard with fewer slots than threads")
+{
+    combining_guarded<std::uint64_t, std::mutex, 2> counter{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 8; ++thread) {
+        threads.emplace_back([&] {
+            for (int iteration = 0; iteration < 10'000; ++iteration) {
+                counter.with_lock_held([](std::uint64_t& value) noexcept { ++value; });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(counter.with_lock_held([](const std::uint64_t& value) { return value; }) == 80'000);
+}
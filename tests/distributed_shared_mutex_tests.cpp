@@ -0,0 +1,161 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <distributed_shared_mutex.h>
+
+TEST_CASE("Distributed Shared Mutex Traits")
+{
+    SECTION("A distributed shared mutex is detected as a shared mutex")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<distributed_shared_mutex<>>,
+                       detail::mutex_category::shared>);
+    }
+
+    SECTION("Reader slots live on separate cache lines")
+    {
+        STATIC_REQUIRE(
+            sizeof(distributed_shared_mutex<std::shared_mutex, 4>) >= 4 * detail::cache_line_size);
+    }
+}
+
+TEST_CASE("Mutex Guard using a distributed_shared_mutex")
+{
+    mutex_guarded<int, distributed_shared_mutex<>> data{ 0 };
+
+    SECTION("Readers take the fast path while the lock is reader-biased")
+    {
+        REQUIRE(data.with_read_lock_held([](const int& value) noexcept { return value; }) == 0);
+
+        const auto first = data.read_lock();
+        const auto second = data.read_lock();
+
+        REQUIRE(*first == 0);
+        REQUIRE(*second == 0);
+    }
+
+    SECTION("Writers revoke the reader bias")
+    {
+        data.with_write_lock_held([](int& value) noexcept { value = 42; });
+        REQUIRE(*data.read_lock() == 42);
+    }
+
+    SECTION("A writer waits for fast-path readers to leave")
+    {
+        std::future<void> future;
+
+        {
+            const auto proxy = data.read_lock();
+
+            future = std::async(std::launch::async, [&] { *data.write_lock() = 7; });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+            REQUIRE(*proxy == 0);
+        }
+
+        future.get();
+        REQUIRE(*data.read_lock() == 7);
+    }
+
+    SECTION("Concurrent readers and writers")
+    {
+        std::atomic<bool> torn_read{ false };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int iteration = 0; iteration < 5'000; ++iteration) {
+                    if (thread == 0) {
+                        data.with_write_lock_held([](int& value) noexcept { value += 2; });
+                    } else {
+                        data.with_read_lock_held([&](const int& value) noexcept {
+                            if (value % 2 != 0) {
+                                torn_read = true;
+                            }
+                        });
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(torn_read == false);
+        REQUIRE(*data.read_lock() == 10'000);
+    }
+}
+
+TEST_CASE("Distributed Shared Mutex")
+{
+    distributed_shared_mutex<> mutex;
+
+    SECTION("Trying to write lock fails while readers are present")
+    {
+        mutex.lock_shared();
+
+        const auto was_locked =
+            std::async(std::launch::async, [&] { return mutex.try_lock(); }).get();
+
+        REQUIRE(was_locked == false);
+
+        mutex.unlock_shared();
+
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+
+    SECTION("A recursive read lock doesn't wait for a writer that waits for the first one")
+    {
+        mutex.lock_shared();
+
+        auto writer = std::async(std::launch::async, [&] {
+            mutex.lock();
+            mutex.unlock();
+        });
+
+        while (mutex.is_reader_biased()) {
+            std::this_thread::yield();
+        }
+
+        REQUIRE(mutex.try_lock_shared());
+        mutex.lock_shared();
+
+        mutex.unlock_shared();
+        mutex.unlock_shared();
+
+        REQUIRE(
+            writer.wait_for(std::chrono::milliseconds{ 20 }) == std::future_status::timeout);
+
+        mutex.unlock_shared();
+        writer.get();
+
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+
+    SECTION("Readers fall back to the underlying mutex after a revocation")
+    {
+        REQUIRE(mutex.is_reader_biased());
+
+        mutex.lock();
+        REQUIRE(mutex.is_reader_biased() == false);
+        mutex.unlock();
+
+        REQUIRE(mutex.try_lock_shared());
+        REQUIRE(mutex.try_lock_shared());
+        mutex.unlock_shared();
+        mutex.unlock_shared();
+
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+}
@@ -0,0 +1,133 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <futex_mutex.h>
+
+TEST_CASE("Futex Mutex Traits")
+{
+    SECTION("Futex mutexes are detected as the right mutex category")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<futex_mutex>, detail::mutex_category::unique>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<futex_shared_mutex>,
+                       detail::mutex_category::shared>);
+    }
+
+    SECTION("Guarding an int with a futex mutex takes eight bytes")
+    {
+        STATIC_REQUIRE(sizeof(mutex_guarded<int, futex_mutex>) == 8);
+        STATIC_REQUIRE(sizeof(mutex_guarded<int, futex_shared_mutex>) == 8);
+    }
+}
+
+TEST_CASE("Mutex Guard using a futex_mutex")
+{
+    mutex_guarded<int, futex_mutex> data{ 0 };
+
+    SECTION("Writing data using a lambda")
+    {
+        data.with_lock_held([](int& value) noexcept { value = 42; });
+        REQUIRE(*data.lock() == 42);
+    }
+
+    SECTION("A sleeping waiter acquires the mutex once it is released")
+    {
+        std::future<int> future;
+
+        {
+            const auto proxy = data.lock();
+
+            future = std::async(std::launch::async, [&] { return ++*data.lock(); });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        }
+
+        REQUIRE(future.get() == 1);
+    }
+
+    SECTION("Concurrent increments are not lost")
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int increment = 0; increment < 10'000; ++increment) {
+                    data.with_lock_held([](int& value) noexcept { ++value; });
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*data.lock() == 40'000);
+    }
+}
+
+TEST_CASE("Mutex Guard using a futex_shared_mutex")
+{
+    mutex_guarded<int, futex_shared_mutex> data{ 0 };
+
+    SECTION("Multiple readers can hold the lock at once")
+    {
+        const auto first = data.read_lock();
+
+        const auto value =
+            std::async(std::launch::async, [&] { return *data.read_lock(); }).get();
+
+        REQUIRE(value == 0);
+    }
+
+    SECTION("A waiting writer acquires the lock once the readers are gone")
+    {
+        std::future<void> future;
+
+        {
+            const auto proxy = data.read_lock();
+
+            future = std::async(std::launch::async, [&] { *data.write_lock() = 7; });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+            REQUIRE(*proxy == 0);
+        }
+
+        future.get();
+        REQUIRE(*data.read_lock() == 7);
+    }
+
+    SECTION("Concurrent readers and writers")
+    {
+        std::atomic<bool> torn_read{ false };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int iteration = 0; iteration < 5'000; ++iteration) {
+                    if (thread % 2 == 0) {
+                        data.with_write_lock_held([](int& value) noexcept { value += 2; });
+                    } else {
+                        data.with_read_lock_held([&](const int& value) noexcept {
+                            if (value % 2 != 0) {
+                                torn_read = true;
+                            }
+                        });
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(torn_read == false);
+        REQUIRE(*data.read_lock() == 20'000);
+    }
+}
@@ -0,0 +1,252 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <lock_statistics.h>
+
+TEST_CASE("Lock Histogram")
+{
+    SECTION("Durations are bucketed logarithmically")
+    {
+        REQUIRE(lock_histogram::bucket_for(std::chrono::nanoseconds{ 0 }) == 0);
+        REQUIRE(lock_histogram::bucket_for(std::chrono::nanoseconds{ 1 }) == 1);
+        REQUIRE(lock_histogram::bucket_for(std::chrono::nanoseconds{ 2 }) == 1);
+        REQUIRE(lock_histogram::bucket_for(std::chrono::nanoseconds{ 3 }) == 2);
+        REQUIRE(lock_histogram::bucket_for(std::chrono::nanoseconds{ 1'000 }) == 9);
+        REQUIRE(
+            lock_histogram::bucket_for(std::chrono::hours{ 24 * 365 }) ==
+            lock_histogram::bucket_count - 1);
+    }
+
+    SECTION("Percentiles are bounded by the upper edge of their bucket")
+    {
+        lock_histogram histogram;
+        histogram.buckets[4] = 99;
+        histogram.buckets[10] = 1;
+
+        REQUIRE(histogram.count() == 100);
+        REQUIRE(histogram.percentile(50) == lock_histogram::lower_bound(5));
+        REQUIRE(histogram.percentile(100) == lock_histogram::lower_bound(11));
+    }
+}
+
+TEST_CASE("Statistics Policy")
+{
+    SECTION("Disabling statistics adds no state")
+    {
+        STATIC_REQUIRE(
+            sizeof(mutex_guarded<std::int64_t, std::mutex, compact_layout, no_statistics>) ==
+            sizeof(mutex_guarded<std::int64_t, std::mutex>));
+
+        STATIC_REQUIRE(
+            sizeof(mutex_guarded<std::int64_t, std::mutex>::unique_lock_proxy) ==
+            sizeof(void*));
+    }
+
+    SECTION("Acquisitions are counted")
+    {
+        mutex_guarded<int, std::mutex, compact_layout, lock_statistics> data{ 0 };
+
+        for (int iteration = 0; iteration < 10; ++iteration) {
+            data.with_lock_held([](int& value) noexcept { ++value; });
+        }
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(snapshot.acquisitions == 10);
+        REQUIRE(snapshot.contended == 0);
+        REQUIRE(snapshot.wait_time.count() == 0);
+        REQUIRE(snapshot.hold_time.count() == 10);
+    }
+
+    SECTION("Contended acquisitions are counted, along with their wait times")
+    {
+        mutex_guarded<int, std::mutex, compact_layout, lock_statistics> data{ 0 };
+
+        std::future<void> future;
+
+        {
+            const auto proxy = data.lock();
+
+            future = std::async(std::launch::async, [&] { ++*data.lock(); });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        }
+
+        future.get();
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(snapshot.acquisitions == 2);
+        REQUIRE(snapshot.contended == 1);
+        REQUIRE(snapshot.wait_time.count() == 1);
+        REQUIRE(snapshot.wait_time.percentile(100) >= std::chrono::milliseconds{ 10 });
+        REQUIRE(snapshot.hold_time.percentile(100) >= std::chrono::milliseconds{ 10 });
+    }
+
+    SECTION("Timed acquisitions that time out are counted as failures only")
+    {
+        mutex_guarded<int, std::shared_timed_mutex, compact_layout, lock_statistics> data{ 0 };
+
+        const auto proxy = data.read_lock();
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return data.try_write_lock_for(std::chrono::milliseconds{ 1 })
+                                        .is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(snapshot.acquisitions == 1);
+        REQUIRE(snapshot.contended == 0);
+        REQUIRE(snapshot.failed == 1);
+        REQUIRE(snapshot.wait_time.count() == 0);
+    }
+
+    SECTION("Failed non-blocking acquisitions are counted as failures only")
+    {
+        mutex_guarded<int, std::mutex, compact_layout, lock_statistics> data{ 0 };
+
+        const auto proxy = data.lock();
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return data.try_lock().is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(snapshot.acquisitions == 1);
+        REQUIRE(snapshot.contended == 0);
+        REQUIRE(snapshot.failed == 1);
+    }
+
+    SECTION("Short-lived guards each start out with fresh statistics")
+    {
+        for (int iteration = 0; iteration < 100; ++iteration) {
+            mutex_guarded<int, std::mutex, compact_layout, lock_statistics> data{ 0 };
+
+            data.with_lock_held([](int& value) noexcept { ++value; });
+            data.with_lock_held([](int& value) noexcept { ++value; });
+
+            REQUIRE(data.statistics().snapshot().acquisitions == 2);
+        }
+    }
+
+    SECTION("Moving a proxy keeps its acquisition, while relocking it counts as a new one")
+    {
+        mutex_guarded<int, std::mutex, compact_layout, lock_statistics> data{ 0 };
+
+        {
+            auto proxy = data.lock();
+            auto moved = std::move(proxy);
+
+            moved.unlock();
+            moved.relock();
+        }
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(snapshot.acquisitions == 2);
+        REQUIRE(snapshot.hold_time.count() == 2);
+    }
+
+    SECTION("Statistics from multiple threads are aggregated")
+    {
+        mutex_guarded<int, std::shared_mutex, compact_layout, lock_statistics> data{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 1'000; ++iteration) {
+                    data.with_write_lock_held([](int& value) noexcept { ++value; });
+                    data.with_read_lock_held([](const int& /*value*/) noexcept {});
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(snapshot.acquisitions == 8'000);
+        REQUIRE(snapshot.hold_time.count() == 8'000);
+    }
+}
+
+TEST_CASE("Statistics Registry")
+{
+    mutex_guarded<int, std::mutex, compact_layout, lock_statistics> first{ 0 };
+    mutex_guarded<int, std::mutex, compact_layout, lock_statistics> second{ 0 };
+
+    first.statistics().set_name("first \"guard\"");
+    second.statistics().set_name("second guard");
+
+    *first.lock() = 1;
+
+    SECTION("All live guards are reported")
+    {
+        const auto snapshots = lock_statistics_registry::instance().snapshot();
+
+        REQUIRE(snapshots.size() >= 2);
+
+        const auto find = [&](const std::string& name) {
+            return std::find_if(snapshots.begin(), snapshots.end(), [&](const auto& snapshot) {
+                return snapshot.name == name;
+            });
+        };
+
+        REQUIRE(find("first \"guard\"") != snapshots.end());
+        REQUIRE(find("first \"guard\"")->acquisitions == 1);
+        REQUIRE(find("second guard") != snapshots.end());
+        REQUIRE(find("second guard")->acquisitions == 0);
+    }
+
+    SECTION("Guards are no longer reported once they've been destroyed")
+    {
+        {
+            mutex_guarded<int, std::mutex, compact_layout, lock_statistics> third{ 0 };
+            third.statistics().set_name("third guard");
+        }
+
+        std::ostringstream stream;
+        lock_statistics_registry::instance().dump_text(stream);
+
+        REQUIRE(stream.str().find("third guard") == std::string::npos);
+    }
+
+    SECTION("Dumping as JSON")
+    {
+        std::ostringstream stream;
+        lock_statistics_registry::instance().dump_json(stream);
+
+        const auto json = stream.str();
+
+        REQUIRE(json.front() == '[');
+        REQUIRE(
+            json.find(R"({"name":"first \"guard\"","acquisitions":1,"contended":0,"failed":0,)") !=
+            std::string::npos);
+        REQUIRE(json.find(R"("name":"second guard")") != std::string::npos);
+    }
+
+    SECTION("Dumping as text")
+    {
+        std::ostringstream stream;
+        lock_statistics_registry::instance().dump_text(stream);
+
+        REQUIRE(stream.str().find("second guard: 0 acquisitions") != std::string::npos);
+    }
+}
@@ -0,0 +1,299 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <lock_statistics.h>
+#include <observable_guarded.h>
+#include <waitable_guarded.h>
+
+TEST_CASE("Change Subscriptions")
+{
+    SECTION("Subscribers are notified once a write lock has been released")
+    {
+        observable_guarded<int> data{ 0 };
+
+        std::vector<std::uint64_t> versions;
+        int value_seen = -1;
+
+        const auto subscription = data.subscribe([&](std::uint64_t version) {
+            versions.push_back(version);
+
+            // This would deadlock if the lock were still held.
+            value_seen = *std::as_const(data).lock();
+        });
+
+        {
+            auto proxy = data.lock();
+            *proxy = 1;
+
+            REQUIRE(versions.empty());
+        }
+
+        REQUIRE(versions == std::vector<std::uint64_t>{ 1 });
+        REQUIRE(value_seen == 1);
+    }
+
+    SECTION("Every kind of write lock notifies the subscribers")
+    {
+        observable_guarded<int, std::shared_mutex> shared{ 0 };
+        observable_guarded<int, std::timed_mutex> timed{ 0 };
+
+        auto notifications = 0;
+        const auto on_change = [&](std::uint64_t) { ++notifications; };
+
+        const auto shared_subscription = shared.subscribe(on_change);
+        const auto timed_subscription = timed.subscribe(on_change);
+
+        shared.with_write_lock_held([](int& value) noexcept { ++value; });
+        REQUIRE(notifications == 1);
+
+        *timed.try_lock_for(std::chrono::milliseconds{ 1 }) = 2;
+        REQUIRE(notifications == 2);
+
+        shared.exchange(3);
+        REQUIRE(notifications == 3);
+    }
+
+    SECTION("Read locks don't notify the subscribers")
+    {
+        observable_guarded<int, std::shared_mutex> data{ 0 };
+
+        auto notifications = 0;
+        const auto subscription = data.subscribe([&](std::uint64_t) { ++notifications; });
+
+        data.with_read_lock_held([](const int&) noexcept {});
+        REQUIRE(*data.read_lock() == 0);
+
+        REQUIRE(notifications == 0);
+    }
+
+    SECTION("Writes during a slow callback are coalesced into a single notification")
+    {
+        observable_guarded<int> data{ 0 };
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool is_in_callback = false;
+        bool may_return = false;
+
+        std::vector<std::uint64_t> versions;
+
+        const auto subscription = data.subscribe([&](std::uint64_t version) {
+            versions.push_back(version);
+
+            std::unique_lock<std::mutex> lock{ mutex };
+            if (version == 1) {
+                is_in_callback = true;
+                condition.notify_all();
+                condition.wait(lock, [&] { return may_return; });
+            }
+        });
+
+        auto writer = std::async(std::launch::async, [&] { *data.lock() = 1; });
+
+        {
+            std::unique_lock<std::mutex> lock{ mutex };
+            condition.wait(lock, [&] { return is_in_callback; });
+        }
+
+        // These don't block on the slow subscriber, which is busy on the writer's thread.
+        for (int value = 2; value <= 5; ++value) {
+            *data.lock() = value;
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock{ mutex };
+            may_return = true;
+            condition.notify_all();
+        }
+
+        writer.get();
+
+        REQUIRE(versions == std::vector<std::uint64_t>{ 1, 5 });
+    }
+
+    SECTION("Unsubscribing stops the notifications")
+    {
+        observable_guarded<int> data{ 0 };
+
+        auto notifications = 0;
+        auto subscription = data.subscribe([&](std::uint64_t) { ++notifications; });
+
+        *data.lock() = 1;
+        subscription.unsubscribe();
+        *data.lock() = 2;
+
+        REQUIRE(subscription.is_subscribed() == false);
+        REQUIRE(notifications == 1);
+
+        {
+            const auto scoped = data.subscribe([&](std::uint64_t) { ++notifications; });
+        }
+
+        *data.lock() = 3;
+        REQUIRE(notifications == 1);
+    }
+
+    SECTION("A callback can unsubscribe itself")
+    {
+        observable_guarded<int> data{ 0 };
+
+        auto notifications = 0;
+        change_subscription subscription;
+        subscription = data.subscribe([&](std::uint64_t) {
+            ++notifications;
+            subscription.unsubscribe();
+        });
+
+        *data.lock() = 1;
+        *data.lock() = 2;
+
+        REQUIRE(notifications == 1);
+    }
+
+    SECTION("A callback that writes to the guard is notified of its own write afterwards")
+    {
+        observable_guarded<int> data{ 0 };
+
+        std::vector<std::uint64_t> versions;
+        const auto subscription = data.subscribe([&](std::uint64_t version) {
+            versions.push_back(version);
+
+            if (version == 1) {
+                *data.lock() = 2;
+            }
+        });
+
+        *data.lock() = 1;
+
+        REQUIRE(versions == std::vector<std::uint64_t>{ 1, 2 });
+    }
+
+    SECTION("Subscribers are notified when a write proxy releases its lock to wait")
+    {
+        mutex_guarded<
+            int, std::mutex, compact_layout, no_statistics, condition_notification,
+            write_subscriptions>
+            data{ 0 };
+
+        std::promise<int> notified;
+        const auto subscription = data.subscribe([&, is_first = true](std::uint64_t) mutable {
+            if (std::exchange(is_first, false)) {
+                notified.set_value(*std::as_const(data).lock());
+            }
+        });
+
+        auto waiter = std::async(std::launch::async, [&] {
+            auto proxy = data.lock();
+            *proxy = 1;
+            proxy.wait([](const int& value) { return value == 2; });
+        });
+
+        auto value_seen = notified.get_future();
+        const auto status = value_seen.wait_for(std::chrono::seconds{ 5 });
+
+        data.modify_and_notify_all([](int& value) {
+            value = 2;
+            return true;
+        });
+
+        waiter.get();
+
+        REQUIRE(status == std::future_status::ready);
+        REQUIRE(value_seen.get() == 1);
+    }
+
+    SECTION("Releasing the lock to wait is recorded in the statistics")
+    {
+        mutex_guarded<
+            int, std::mutex, compact_layout, lock_statistics, condition_notification,
+            write_subscriptions>
+            data{ 0 };
+
+        std::promise<void> notified;
+        const auto subscription = data.subscribe([&, is_first = true](std::uint64_t) mutable {
+            if (std::exchange(is_first, false)) {
+                notified.set_value();
+            }
+        });
+
+        auto waiter = std::async(std::launch::async, [&] {
+            auto proxy = data.lock();
+            *proxy = 1;
+            proxy.wait([](const int& value) { return value == 2; });
+        });
+
+        const auto status = notified.get_future().wait_for(std::chrono::seconds{ 5 });
+
+        data.modify_and_notify_all([](int& value) {
+            value = 2;
+            return true;
+        });
+
+        waiter.get();
+
+        const auto snapshot = data.statistics().snapshot();
+
+        REQUIRE(status == std::future_status::ready);
+        REQUIRE(snapshot.acquisitions == 3);
+        REQUIRE(snapshot.hold_time.count() == 3);
+    }
+
+    SECTION("A subscription may outlive its guard")
+    {
+        change_subscription subscription;
+
+        {
+            observable_guarded<int> data{ 0 };
+            subscription = data.subscribe([](std::uint64_t) {});
+        }
+
+        subscription.unsubscribe();
+        REQUIRE(subscription.is_subscribed() == false);
+    }
+
+    SECTION("Subscribers can come and go while other threads write")
+    {
+        observable_guarded<int> data{ 0 };
+
+        std::atomic<std::uint64_t> latest{ 0 };
+        const auto subscription = data.subscribe([&](std::uint64_t version) {
+            auto previous = latest.load();
+            while (previous < version && !latest.compare_exchange_weak(previous, version)) {
+            }
+        });
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 2; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 1'000; ++iteration) {
+                    data.with_lock_held([](int& value) noexcept { ++value; });
+                }
+            });
+        }
+
+        for (int thread = 0; thread < 2; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 100; ++iteration) {
+                    const auto transient = data.subscribe([](std::uint64_t) {});
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(latest.load() == 2'000);
+        REQUIRE(data.version() == 2'000);
+    }
+}
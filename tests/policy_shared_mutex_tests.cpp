@@ -0,0 +1,238 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <policy_shared_mutex.h>
+
+namespace
+{
+/**
+ * @brief Lets a reader and then a writer queue up behind a writer that holds the lock.
+ *
+ * @returns The order in which the two waiters acquired the lock once it was released.
+ */
+template <typename PolicyType> auto order_of_waiters() -> std::vector<std::string>
+{
+    mutex_guarded<int, policy_shared_mutex<PolicyType>> data{ 0 };
+    mutex_guarded<std::vector<std::string>> order;
+
+    std::thread reader;
+    std::thread writer;
+
+    {
+        const auto proxy = data.write_lock();
+
+        reader = std::thread{ [&] {
+            const auto guard = data.read_lock();
+            order.lock()->push_back("reader");
+        } };
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+        writer = std::thread{ [&] {
+            const auto guard = data.write_lock();
+            order.lock()->push_back("writer");
+        } };
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+    }
+
+    reader.join();
+    writer.join();
+
+    return *order.lock();
+}
+
+/**
+ * @returns Whether a new reader gets the lock while a reader holds it and a writer waits for it.
+ */
+template <typename PolicyType> auto is_reader_admitted_past_waiting_writer() -> bool
+{
+    mutex_guarded<int, policy_shared_mutex<PolicyType>> data{ 0 };
+
+    std::thread writer;
+    auto is_admitted = false;
+
+    {
+        const auto proxy = data.read_lock();
+
+        writer = std::thread{ [&] { *data.write_lock() = 1; } };
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+
+        is_admitted =
+            std::async(std::launch::async, [&] { return data.try_read_lock().is_locked(); }).get();
+    }
+
+    writer.join();
+    return is_admitted;
+}
+} // namespace
+
+TEST_CASE("Policy Shared Mutex Traits")
+{
+    SECTION("Policy shared mutexes are detected as the right mutex category")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<policy_shared_mutex<reader_preferring>>,
+                       detail::mutex_category::shared>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<policy_shared_mutex<writer_preferring>>,
+                       detail::mutex_category::shared>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<phase_fair_shared_mutex>,
+                       detail::mutex_category::shared>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<phase_fair_shared_timed_mutex>,
+                       detail::mutex_category::shared_and_timed>);
+    }
+}
+
+TEMPLATE_TEST_CASE(
+    "Mutex Guard using a policy_shared_timed_mutex", "", reader_preferring, writer_preferring,
+    phase_fair)
+{
+    mutex_guarded<int, policy_shared_timed_mutex<TestType>> data{ 0 };
+
+    constexpr auto timeout = std::chrono::milliseconds{ 10 };
+
+    SECTION("Multiple readers can hold the lock at once")
+    {
+        const auto first = data.read_lock();
+        const auto second = data.try_read_lock_for(timeout);
+
+        REQUIRE(second.is_locked());
+    }
+
+    SECTION("Writers are excluded by readers")
+    {
+        const auto proxy = data.read_lock();
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return data.try_write_lock_for(timeout).is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+    }
+
+    SECTION("Readers are excluded by writers")
+    {
+        const auto proxy = data.write_lock();
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return data.try_read_lock_for(timeout).is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+    }
+
+    SECTION("A writer that times out lets the readers that it held back in")
+    {
+        const auto proxy = data.read_lock();
+
+        auto writer = std::async(std::launch::async, [&] {
+            return data.try_write_lock_for(std::chrono::milliseconds{ 50 }).is_locked();
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+
+        auto reader = std::async(std::launch::async, [&] {
+            return data.try_read_lock_for(std::chrono::seconds{ 10 }).is_locked();
+        });
+
+        REQUIRE(writer.get() == false);
+        REQUIRE(reader.get() == true);
+    }
+
+    SECTION("Concurrent readers and writers")
+    {
+        std::atomic<bool> torn_read{ false };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int iteration = 0; iteration < 5'000; ++iteration) {
+                    if (thread % 2 == 0) {
+                        auto proxy = data.write_lock();
+                        ++*proxy;
+                        ++*proxy;
+                    } else if (*data.read_lock() % 2 != 0) {
+                        torn_read = true;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(torn_read == false);
+        REQUIRE(*data.read_lock() == 20'000);
+    }
+}
+
+TEST_CASE("Reader-Writer Policies")
+{
+    SECTION("A reader-preferring mutex admits readers past a waiting writer")
+    {
+        REQUIRE(is_reader_admitted_past_waiting_writer<reader_preferring>());
+    }
+
+    SECTION("A writer-preferring mutex holds off readers while a writer waits")
+    {
+        REQUIRE_FALSE(is_reader_admitted_past_waiting_writer<writer_preferring>());
+    }
+
+    SECTION("A phase-fair mutex holds off readers while a writer waits")
+    {
+        REQUIRE_FALSE(is_reader_admitted_past_waiting_writer<phase_fair>());
+    }
+
+    SECTION("A writer-preferring mutex passes the lock on to the next writer")
+    {
+        REQUIRE(
+            order_of_waiters<writer_preferring>() ==
+            std::vector<std::string>{ "writer", "reader" });
+    }
+
+    SECTION("A phase-fair mutex hands the lock to the waiting readers before the next writer")
+    {
+        REQUIRE(order_of_waiters<phase_fair>() == std::vector<std::string>{ "reader", "writer" });
+    }
+
+    SECTION("A phase-fair mutex doesn't let overlapping readers starve a writer")
+    {
+        mutex_guarded<int, phase_fair_shared_timed_mutex> data{ 0 };
+        std::atomic<bool> should_stop{ false };
+
+        // Each reader holds the lock for long enough that there is always another reader inside.
+        std::vector<std::thread> readers;
+        for (int thread = 0; thread < 4; ++thread) {
+            readers.emplace_back([&] {
+                while (!should_stop) {
+                    const auto proxy = data.read_lock();
+                    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        const auto was_locked = data.try_write_lock_for(std::chrono::seconds{ 10 }).is_locked();
+
+        should_stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        REQUIRE(was_locked);
+    }
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <queue_mutex.h>
+
+TEST_CASE("Queue Mutex Traits")
+{
+    SECTION("Queue mutexes are detected as exclusive mutexes")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<ticket_mutex>,
+                       detail::mutex_category::unique>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<mcs_mutex>, detail::mutex_category::unique>);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::detect_mutex_category<clh_mutex>, detail::mutex_category::unique>);
+    }
+
+    SECTION("A ticket mutex takes eight bytes")
+    {
+        STATIC_REQUIRE(sizeof(ticket_mutex) == 8);
+    }
+}
+
+TEMPLATE_TEST_CASE("Mutex Guard using a queue mutex", "", ticket_mutex, mcs_mutex, clh_mutex)
+{
+    mutex_guarded<int, TestType> data{ 0 };
+
+    SECTION("Writing data using a lambda")
+    {
+        data.with_lock_held([](int& value) noexcept { value = 42; });
+        REQUIRE(*data.lock() == 42);
+    }
+
+    SECTION("Trying to lock a held mutex fails")
+    {
+        {
+            const auto proxy = data.lock();
+
+            const auto was_locked =
+                std::async(std::launch::async, [&] { return data.try_lock().is_locked(); }).get();
+
+            REQUIRE(was_locked == false);
+        }
+
+        REQUIRE(data.try_lock().is_locked());
+    }
+
+    SECTION("Waiters are granted the lock in the order in which they arrived")
+    {
+        TestType mutex;
+        std::vector<int> order;
+        std::vector<std::thread> threads;
+
+        mutex.lock();
+
+        for (int thread = 0; thread < 3; ++thread) {
+            const auto tail = detail::queue_inspector::tail(mutex);
+
+            threads.emplace_back([&, thread] {
+                const std::lock_guard<TestType> guard{ mutex };
+                order.push_back(thread);
+            });
+
+            // Wait for the waiter to join the queue before the next one arrives.
+            while (detail::queue_inspector::tail(mutex) == tail) {
+                std::this_thread::yield();
+            }
+        }
+
+        mutex.unlock();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(order == std::vector<int>{ 0, 1, 2 });
+    }
+
+    SECTION("Concurrent increments are not lost")
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&] {
+                for (int increment = 0; increment < 10'000; ++increment) {
+                    data.with_lock_held([](int& value) noexcept { ++value; });
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*data.lock() == 80'000);
+    }
+
+    SECTION("Non-blocking attempts never wait, even when mixed with blocking acquisitions")
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int increment = 0; increment < 10'000; ++increment) {
+                    if (thread % 2 == 0) {
+                        data.with_lock_held([](int& value) noexcept { ++value; });
+                        continue;
+                    }
+
+                    while (!data.try_with_lock_held([](int& value) noexcept { ++value; })) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*data.lock() == 40'000);
+    }
+
+    SECTION("Several queue mutexes can be held at once")
+    {
+        mutex_guarded<int, TestType> other{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int increment = 0; increment < 1'000; ++increment) {
+                    auto [first, second] = lock_all(data, other);
+                    ++*first;
+                    ++*second;
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*data.lock() == 4'000);
+        REQUIRE(*other.lock() == 4'000);
+    }
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rcu_guarded.h>
+
+namespace
+{
+std::atomic<int> live_instances{ 0 };
+
+struct routing_table
+{
+    routing_table()
+    {
+        ++live_instances;
+    }
+
+    routing_table(const routing_table& other)
+        : routes{ other.routes }, generation{ other.generation }
+    {
+        ++live_instances;
+    }
+
+    ~routing_table()
+    {
+        --live_instances;
+        generation = -1;
+    }
+
+    std::map<std::string, int> routes;
+    int generation = 0;
+};
+} // namespace
+
+TEST_CASE("RCU Guard")
+{
+    rcu_guarded<routing_table> data;
+
+    REQUIRE(live_instances.load() == 1);
+
+    SECTION("Reading data using a proxy")
+    {
+        REQUIRE(data.read_lock().is_locked());
+        REQUIRE(data.read_lock()->generation == 0);
+    }
+
+    SECTION("Writing data using a lambda, returning something")
+    {
+        const auto generation = data.with_write_lock_held([](routing_table& table) {
+            table.routes["/"] = 80;
+            return ++table.generation;
+        });
+
+        REQUIRE(generation == 1);
+
+        const auto port = data.with_read_lock_held(
+            [](const routing_table& table) { return table.routes.at("/"); });
+
+        REQUIRE(port == 80);
+
+        // The previous version should have been reclaimed by the time the write returns:
+        REQUIRE(live_instances.load() == 1);
+    }
+
+    SECTION("Nested reads are supported")
+    {
+        data.with_read_lock_held([&](const routing_table& outer) {
+            data.with_read_lock_held(
+                [&](const routing_table& inner) { REQUIRE(&outer == &inner); });
+        });
+    }
+
+    SECTION("Writers wait for readers before reclaiming a snapshot")
+    {
+        std::promise<void> reader_has_snapshot;
+        std::promise<void> reader_may_finish;
+
+        auto reader = std::async(std::launch::async, [&] {
+            const auto proxy = data.read_lock();
+            reader_has_snapshot.set_value();
+            reader_may_finish.get_future().wait();
+
+            // The snapshot must still be intact, even though a newer version was published:
+            return proxy->generation;
+        });
+
+        reader_has_snapshot.get_future().wait();
+
+        auto writer = std::async(std::launch::async, [&] {
+            data.with_write_lock_held([](routing_table& table) { table.generation = 42; });
+        });
+
+        REQUIRE(
+            writer.wait_for(std::chrono::milliseconds{ 50 }) == std::future_status::timeout);
+
+        // New readers already observe the new version:
+        REQUIRE(data.read_lock()->generation == 42);
+
+        reader_may_finish.set_value();
+
+        REQUIRE(reader.get() == 0);
+        writer.get();
+
+        REQUIRE(live_instances.load() == 1);
+    }
+
+    SECTION("Concurrent readers and writers")
+    {
+        std::atomic<bool> should_stop{ false };
+        std::atomic<bool> saw_reclaimed_data{ false };
+
+        std::vector<std::thread> readers;
+        for (int index = 0; index < 2; ++index) {
+            readers.emplace_back([&] {
+                while (!should_stop.load()) {
+                    data.with_read_lock_held([&](const routing_table& table) {
+                        if (table.generation < 0) {
+                            saw_reclaimed_data.store(true);
+                        }
+                    });
+                }
+            });
+        }
+
+        for (int generation = 1; generation <= 200; ++generation) {
+            data.with_write_lock_held([&](routing_table& table) { table.generation = generation; });
+        }
+
+        should_stop.store(true);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        REQUIRE(saw_reclaimed_data.load() == false);
+        REQUIRE(data.read_lock()->generation == 200);
+    }
+}
+
+TEST_CASE("RCU Guard as a drop-in for a shared mutex_guarded")
+{
+    const auto update_and_read = [](auto& guarded) {
+        guarded.with_write_lock_held([](std::vector<int>& values) { values.push_back(1); });
+        return guarded.with_read_lock_held(
+            [](const std::vector<int>& values) { return values.size(); });
+    };
+
+    mutex_guarded<std::vector<int>, std::shared_mutex> locked;
+    rcu_guarded<std::vector<int>> copied;
+
+    REQUIRE(update_and_read(locked) == 1);
+    REQUIRE(update_and_read(copied) == 1);
+}
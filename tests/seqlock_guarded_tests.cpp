@@ -0,0 +1,118 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <seqlock_guarded.h>
+
+namespace
+{
+struct config_snapshot
+{
+    std::uint64_t version = 0;
+    std::uint32_t limits[6] = {};
+    std::uint64_t checksum = 0;
+};
+
+auto make_snapshot(std::uint64_t version) -> config_snapshot
+{
+    config_snapshot snapshot;
+    snapshot.version = version;
+
+    for (auto& limit : snapshot.limits) {
+        limit = static_cast<std::uint32_t>(version);
+    }
+
+    snapshot.checksum = ~version;
+    return snapshot;
+}
+} // namespace
+
+TEST_CASE("Seqlock Guard")
+{
+    seqlock_guarded<config_snapshot> data{ make_snapshot(1) };
+
+    SECTION("Reading data using a lambda, returning something")
+    {
+        const auto version =
+            data.with_read_lock_held([](const config_snapshot& value) { return value.version; });
+
+        REQUIRE(version == 1);
+    }
+
+    SECTION("Writing data using a lambda, returning nothing")
+    {
+        data.with_write_lock_held([](config_snapshot& value) { value = make_snapshot(2); });
+
+        REQUIRE(data.read().version == 2);
+        REQUIRE(data.sequence() % 2 == 0);
+    }
+
+    SECTION("Writing data using a lambda, returning something")
+    {
+        const auto previous = data.with_write_lock_held([](config_snapshot& value) {
+            const auto version = value.version;
+            value = make_snapshot(version + 1);
+            return version;
+        });
+
+        REQUIRE(previous == 1);
+        REQUIRE(data.read().checksum == ~std::uint64_t{ 2 });
+    }
+
+    SECTION("Readers never observe a partially written value")
+    {
+        std::atomic<bool> should_stop{ false };
+        std::atomic<bool> saw_torn_value{ false };
+
+        std::vector<std::thread> readers;
+        for (int index = 0; index < 2; ++index) {
+            readers.emplace_back([&] {
+                while (!should_stop.load()) {
+                    data.with_read_lock_held([&](const config_snapshot& value) {
+                        const auto expected = make_snapshot(value.version);
+                        for (std::size_t limit = 0; limit < 6; ++limit) {
+                            if (value.limits[limit] != expected.limits[limit]) {
+                                saw_torn_value.store(true);
+                            }
+                        }
+
+                        if (value.checksum != expected.checksum) {
+                            saw_torn_value.store(true);
+                        }
+                    });
+                }
+            });
+        }
+
+        for (std::uint64_t version = 2; version < 20'000; ++version) {
+            data.write(make_snapshot(version));
+        }
+
+        should_stop.store(true);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        REQUIRE(saw_torn_value.load() == false);
+    }
+}
+
+TEST_CASE("Seqlock Guard as a drop-in for a shared mutex_guarded")
+{
+    // The same generic code should compile against either type:
+    const auto increment_and_read = [](auto& guarded) {
+        guarded.with_write_lock_held([](config_snapshot& value) { ++value.version; });
+        return guarded.with_read_lock_held(
+            [](const config_snapshot& value) { return value.version; });
+    };
+
+    mutex_guarded<config_snapshot, std::shared_mutex> locked{ make_snapshot(1) };
+    seqlock_guarded<config_snapshot> sequenced{ make_snapshot(1) };
+
+    REQUIRE(increment_and_read(locked) == 2);
+    REQUIRE(increment_and_read(sequenced) == 2);
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch.hpp>
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include <sharded_guarded.h>
+
+TEST_CASE("Sharded Guard using a std::mutex", "[Std]")
+{
+    using map_type = std::unordered_map<std::string, int>;
+
+    sharded_guarded<map_type, 8, std::mutex> data;
+
+    STATIC_REQUIRE(decltype(data)::shard_count == 8);
+
+    SECTION("Keys are consistently routed to the same shard")
+    {
+        const std::string key = "apple";
+
+        data.with_shard_for(key, [&](map_type& map) { map[key] = 1; });
+        data.with_shard_for(key, [&](map_type& map) { map[key] += 1; });
+
+        const auto value = data.with_shard_for(key, [&](map_type& map) { return map.at(key); });
+
+        REQUIRE(value == 2);
+        REQUIRE(data.shard(data.shard_index_for(key)).lock()->count(key) == 1);
+    }
+
+    SECTION("A key maps onto the same shard no matter how it's passed in")
+    {
+        const std::string key = "alpha";
+        const char* const pointer = "alpha";
+
+        REQUIRE(data.shard_index_for(pointer) == data.shard_index_for(key));
+        REQUIRE(data.shard_index_for("alpha") == data.shard_index_for(key));
+
+        data.with_shard_for(key, [&](map_type& map) { map[key] = 1; });
+
+        const auto count =
+            data.with_shard_for(pointer, [&](map_type& map) { return map.count(pointer); });
+
+        REQUIRE(count == 1);
+        REQUIRE(data.with_shard_for("alpha", [](map_type& map) { return map.at("alpha"); }) == 1);
+    }
+
+    SECTION("Locking all shards observes every key")
+    {
+        for (int index = 0; index < 100; ++index) {
+            const auto key = std::to_string(index);
+            data.with_shard_for(key, [&](map_type& map) { map[key] = index; });
+        }
+
+        const auto size = data.with_all_shards_locked([](const auto& shards) {
+            std::size_t total = 0;
+            for (const auto* shard : shards) {
+                total += shard->size();
+            }
+
+            return total;
+        });
+
+        REQUIRE(size == 100);
+    }
+}
+
+TEST_CASE("Sharded Guard using a std::shared_timed_mutex", "[Std]")
+{
+    using map_type = std::unordered_map<int, int>;
+
+    sharded_guarded<map_type, 4, std::shared_timed_mutex> data;
+
+    constexpr auto timeout = std::chrono::milliseconds{ 10 };
+
+    SECTION("Reading and writing a single shard")
+    {
+        data.with_write_shard_for(42, [](map_type& map) { map[42] = 7; });
+
+        const auto value =
+            data.with_read_shard_for(42, [](const map_type& map) { return map.at(42); });
+        REQUIRE(value == 7);
+    }
+
+    SECTION("Timed access to a single shard")
+    {
+        const auto wasLocked =
+            data.try_with_write_shard_for(1, timeout, [](map_type& map) { map[1] = 1; });
+
+        REQUIRE(wasLocked == true);
+
+        const auto value =
+            data.try_with_read_shard_for(1, timeout, [](const map_type& map) { return map.at(1); });
+
+        REQUIRE(value.has_value());
+        REQUIRE(*value == 1);
+    }
+
+    SECTION("Timed access to all shards fails if a single shard is contended")
+    {
+        const auto proxy = data.shard(2).write_lock();
+
+        const auto wasLocked = data.try_with_all_shards_write_locked_for(
+            timeout, [](const auto& /*shards*/) noexcept {});
+
+        REQUIRE(wasLocked == false);
+
+        // Ensure that the shards locked before the contended shard were released again:
+        REQUIRE(data.shard(0).try_write_lock_for(timeout).is_locked());
+        REQUIRE(data.shard(1).try_write_lock_for(timeout).is_locked());
+    }
+
+    SECTION("Timed access to all shards")
+    {
+        for (int key = 0; key < 16; ++key) {
+            data.with_write_shard_for(key, [&](map_type& map) { map[key] = key; });
+        }
+
+        const auto size = data.try_with_all_shards_read_locked_for(timeout, [](const auto& shards) {
+            std::size_t total = 0;
+            for (const auto* shard : shards) {
+                total += shard->size();
+            }
+
+            return total;
+        });
+
+        REQUIRE(size.has_value());
+        REQUIRE(*size == 16);
+    }
+}
@@ -4,7 +4,19 @@
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <optional>
 #include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <mutex_guarded.h>
 
@@ -217,6 +229,40 @@ class wrapped_shared_and_timed_mutex
   private:
     mutable MutexType m_mutex;
 };
+
+/**
+ * @brief Records whether the tracked mutex had been unlocked by the time that the probe was
+ * destroyed. Moved-from probes record nothing.
+ */
+class destruction_probe
+{
+  public:
+    explicit destruction_probe(bool* was_unlocked_at_destruction = nullptr) noexcept
+        : m_result{ was_unlocked_at_destruction }
+    {
+    }
+
+    destruction_probe(destruction_probe&& other) noexcept
+        : m_result{ std::exchange(other.m_result, nullptr) }
+    {
+    }
+
+    destruction_probe& operator=(destruction_probe&& other) noexcept
+    {
+        m_result = std::exchange(other.m_result, nullptr);
+        return *this;
+    }
+
+    ~destruction_probe() noexcept
+    {
+        if (m_result) {
+            *m_result = tracker.was_unlocked;
+        }
+    }
+
+  private:
+    bool* m_result;
+};
 } // namespace detail
 
 TEST_CASE("Trait Detection")
@@ -254,6 +300,16 @@ TEST_CASE("Trait Detection")
         STATIC_REQUIRE(detail::traits::is_timed_mutex<boost::shared_mutex>::value == false);
         STATIC_REQUIRE(detail::traits::is_timed_shared_mutex<boost::shared_mutex>::value == false);
     }
+
+    SECTION("Upgradeable locking capabilities", "[Boost]")
+    {
+        STATIC_REQUIRE(detail::traits::is_upgrade_mutex<std::shared_mutex>::value == false);
+        STATIC_REQUIRE(detail::traits::is_upgrade_mutex<boost::upgrade_mutex>::value == true);
+
+        STATIC_REQUIRE(std::is_same_v<
+                       detail::mutex_traits<boost::upgrade_mutex>::category_type,
+                       detail::mutex_category::upgrade>);
+    }
 }
 
 TEST_CASE("Simple sanity checks")
@@ -854,3 +910,745 @@ TEST_CASE("Shared Timed Mutex without Contention")
         REQUIRE(detail::tracker.was_unlocked == true);
     }
 }
+
+TEST_CASE("Memory Layout")
+{
+    constexpr auto cache_line_size = detail::cache_line_size;
+
+    SECTION("Compact layout adds no padding")
+    {
+        STATIC_REQUIRE(
+            sizeof(mutex_guarded<std::int64_t, std::mutex>) ==
+            sizeof(std::mutex) + sizeof(std::int64_t));
+
+        STATIC_REQUIRE(alignof(mutex_guarded<std::int64_t, std::mutex>) == alignof(std::mutex));
+    }
+
+    SECTION("Padded layout occupies whole cache lines")
+    {
+        using guarded_type = mutex_guarded<std::int32_t, std::mutex, padded_layout>;
+
+        STATIC_REQUIRE(alignof(guarded_type) == cache_line_size);
+        STATIC_REQUIRE(sizeof(guarded_type) == cache_line_size);
+    }
+
+    SECTION("Split layout places the mutex and the data on separate cache lines")
+    {
+        using guarded_type = mutex_guarded<std::int32_t, std::mutex, split_layout>;
+
+        STATIC_REQUIRE(alignof(guarded_type) == cache_line_size);
+        STATIC_REQUIRE(sizeof(guarded_type) == 2 * cache_line_size);
+    }
+
+    SECTION("Adaptive layout picks a layout based on the size of the data")
+    {
+        struct large_type
+        {
+            char buffer[cache_line_size];
+        };
+
+        STATIC_REQUIRE(sizeof(padded_mutex_guarded<std::int32_t>) == cache_line_size);
+        STATIC_REQUIRE(sizeof(padded_mutex_guarded<large_type>) == 2 * cache_line_size);
+    }
+
+    SECTION("Neighbouring elements never share a cache line")
+    {
+        std::vector<padded_mutex_guarded<std::int32_t>> counters(4);
+
+        for (auto& counter : counters) {
+            REQUIRE(reinterpret_cast<std::uintptr_t>(&counter) % cache_line_size == 0);
+
+            counter.with_lock_held([](std::int32_t& value) noexcept { ++value; });
+            REQUIRE(*counter.lock() == 1);
+        }
+    }
+}
+
+TEST_CASE("Locking Multiple Guards")
+{
+    mutex_guarded<std::deque<int>, std::mutex> source{ std::deque<int>{ 1, 2, 3 } };
+    mutex_guarded<std::deque<int>, std::mutex> destination;
+
+    SECTION("Locking a single guard")
+    {
+        auto [proxy] = lock_all(source);
+        REQUIRE(proxy->size() == 3);
+    }
+
+    SECTION("Moving an item between two guards using proxies")
+    {
+        {
+            auto [from, to] = lock_all(source, destination);
+
+            to->push_back(from->front());
+            from->pop_front();
+        }
+
+        REQUIRE(source.lock()->size() == 2);
+        REQUIRE(destination.lock()->front() == 1);
+    }
+
+    SECTION("Moving an item between two guards using a lambda")
+    {
+        const auto item = with_all_locked(
+            [](std::deque<int>& from, std::deque<int>& to) {
+                to.push_back(from.back());
+                from.pop_back();
+                return to.back();
+            },
+            source, destination);
+
+        REQUIRE(item == 3);
+        REQUIRE(source.lock()->size() == 2);
+    }
+
+    SECTION("Const guards with a shared mutex are locked in shared mode")
+    {
+        mutex_guarded<int, std::shared_timed_mutex> shared{ 42 };
+
+        const auto reader = shared.read_lock();
+
+        // If the guard were locked exclusively, this would deadlock against the reader above:
+        const auto value = with_all_locked(
+            [](const int& value, std::deque<int>& items) { return value + items.front(); },
+            std::as_const(shared), source);
+
+        REQUIRE(value == 43);
+    }
+
+    SECTION("Non-const guards with a shared mutex are locked exclusively")
+    {
+        mutex_guarded<int, std::shared_timed_mutex> shared{ 42 };
+
+        auto [value, items] = lock_all(shared, source);
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return shared.try_read_lock_for(std::chrono::milliseconds{ 1 })
+                                        .is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+    }
+
+    SECTION("Locking guards in opposite orders does not deadlock")
+    {
+        constexpr int iterations = 10'000;
+
+        auto first = std::async(std::launch::async, [&] {
+            for (int iteration = 0; iteration < iterations; ++iteration) {
+                with_all_locked(
+                    [](std::deque<int>& from, std::deque<int>& to) {
+                        if (!from.empty()) {
+                            to.push_back(from.front());
+                            from.pop_front();
+                        }
+                    },
+                    source, destination);
+            }
+        });
+
+        auto second = std::async(std::launch::async, [&] {
+            for (int iteration = 0; iteration < iterations; ++iteration) {
+                with_all_locked(
+                    [](std::deque<int>& from, std::deque<int>& to) {
+                        if (!from.empty()) {
+                            to.push_back(from.front());
+                            from.pop_front();
+                        }
+                    },
+                    destination, source);
+            }
+        });
+
+        first.get();
+        second.get();
+
+        auto [from, to] = lock_all(source, destination);
+        REQUIRE(from->size() + to->size() == 3);
+    }
+}
+
+TEST_CASE("Upgradeable Locking", "[Boost]")
+{
+    mutex_guarded<std::vector<int>, boost::upgrade_mutex> data{ std::vector<int>{ 1, 2, 3 } };
+
+    SECTION("Upgradeable locks grant read-only access")
+    {
+        STATIC_REQUIRE(std::is_same_v<
+                       decltype(*data.upgradeable_lock()), const std::vector<int>&>);
+
+        const auto proxy = data.upgradeable_lock();
+        REQUIRE(proxy.is_locked());
+        REQUIRE(proxy->size() == 3);
+    }
+
+    SECTION("Upgradeable locks coexist with readers")
+    {
+        const auto proxy = data.upgradeable_lock();
+
+        std::async(std::launch::async, [&] {
+            const auto reader = data.read_lock();
+            REQUIRE(reader->size() == 3);
+        }).get();
+    }
+
+    SECTION("Upgrading to an exclusive lock")
+    {
+        auto proxy = data.upgradeable_lock();
+        REQUIRE(proxy->size() == 3);
+
+        auto writer = proxy.upgrade();
+        REQUIRE(proxy.is_locked() == false);
+        REQUIRE(writer.is_locked());
+
+        writer->push_back(4);
+        REQUIRE(writer->size() == 4);
+    }
+
+    SECTION("Downgrading to a shared lock lets other readers in")
+    {
+        auto writer = data.write_lock();
+        writer->push_back(4);
+
+        const auto reader = writer.downgrade();
+        REQUIRE(writer.is_locked() == false);
+        REQUIRE(reader->size() == 4);
+
+        const auto other_size = std::async(std::launch::async, [&] {
+                                    return data.read_lock()->size();
+                                }).get();
+
+        REQUIRE(other_size == 4);
+    }
+
+    SECTION("Upgradeable locks can be attempted with a timeout")
+    {
+        using namespace std::chrono_literals;
+
+        REQUIRE(data.try_upgradeable_lock_for(1ms).is_locked());
+
+        const auto writer = data.write_lock();
+
+        const auto was_locked = std::async(std::launch::async, [&] {
+                                    return data.try_upgradeable_lock_for(1ms).is_locked();
+                                }).get();
+
+        REQUIRE(was_locked == false);
+    }
+
+    SECTION("Filling in a missing entry without re-validating the check")
+    {
+        const auto find_or_insert = [&](int value) {
+            return data.with_upgradeable_lock_held(
+                [&](const std::vector<int>& values, auto upgrade) {
+                    if (std::find(values.begin(), values.end(), value) != values.end()) {
+                        return false;
+                    }
+
+                    upgrade().push_back(value);
+                    return true;
+                });
+        };
+
+        REQUIRE(find_or_insert(2) == false);
+        REQUIRE(find_or_insert(4) == true);
+        REQUIRE(find_or_insert(4) == false);
+        REQUIRE(data.read_lock()->size() == 4);
+    }
+
+    SECTION("Concurrent check-then-act sequences insert each value only once")
+    {
+        const auto insert_all = [&] {
+            for (int value = 0; value < 100; ++value) {
+                data.with_upgradeable_lock_held([&](const std::vector<int>& values, auto upgrade) {
+                    if (std::find(values.begin(), values.end(), value) == values.end()) {
+                        upgrade().push_back(value);
+                    }
+                });
+            }
+        };
+
+        auto first = std::async(std::launch::async, insert_all);
+        auto second = std::async(std::launch::async, insert_all);
+
+        first.get();
+        second.get();
+
+        REQUIRE(data.read_lock()->size() == 100);
+    }
+}
+
+TEST_CASE("Non-Blocking and Deadline Locking")
+{
+    using namespace std::chrono_literals;
+
+    SECTION("Trying to lock a free mutex succeeds")
+    {
+        mutex_guarded<int> data{ 1 };
+
+        REQUIRE(data.try_lock().is_locked());
+
+        const std::optional<int> value =
+            data.try_with_lock_held([](int& value) { return ++value; });
+
+        REQUIRE(value == 2);
+    }
+
+    SECTION("Trying to lock a held mutex fails without blocking")
+    {
+        mutex_guarded<int> data{ 1 };
+
+        const auto proxy = data.lock();
+
+        const auto result = std::async(std::launch::async, [&] {
+                                auto wasLambdaInvoked = false;
+                                const auto wasLocked = data.try_with_lock_held(
+                                    [&](int&) noexcept { wasLambdaInvoked = true; });
+
+                                return wasLocked || wasLambdaInvoked || data.try_lock().is_locked();
+                            }).get();
+
+        REQUIRE(result == false);
+    }
+
+    SECTION("Timed locking is emulated for mutexes that don't support it")
+    {
+        mutex_guarded<int> data{ 1 };
+
+        const auto proxy = data.lock();
+
+        const auto elapsed = std::async(std::launch::async, [&] {
+                                 const auto start = std::chrono::steady_clock::now();
+                                 const auto value = data.try_with_lock_held_for(
+                                     10ms, [](const int& value) { return value; });
+
+                                 REQUIRE(value.has_value() == false);
+                                 return std::chrono::steady_clock::now() - start;
+                             }).get();
+
+        REQUIRE(elapsed >= 10ms);
+    }
+
+    SECTION("An emulated timed lock is acquired once the mutex is released")
+    {
+        mutex_guarded<int> data{ 1 };
+
+        auto proxy = std::optional<mutex_guarded<int>::unique_lock_proxy>{};
+        proxy.emplace(&data);
+
+        auto future = std::async(std::launch::async, [&] {
+            return data.try_with_lock_held_for(10s, [](int& value) { return ++value; });
+        });
+
+        std::this_thread::sleep_for(1ms);
+        proxy.reset();
+
+        REQUIRE(future.get() == 2);
+    }
+
+    SECTION("A single deadline bounds a chain of acquisitions")
+    {
+        mutex_guarded<int> first{ 1 };
+        mutex_guarded<int, std::timed_mutex> second{ 2 };
+
+        const auto proxy = second.lock();
+
+        const auto result = std::async(std::launch::async, [&] {
+                                const auto deadline = std::chrono::steady_clock::now() + 10ms;
+
+                                const auto firstProxy = first.try_lock_until(deadline);
+                                const auto secondProxy = second.try_lock_until(deadline);
+
+                                return std::make_pair(
+                                    firstProxy.is_locked(), secondProxy.is_locked());
+                            }).get();
+
+        REQUIRE(result.first == true);
+        REQUIRE(result.second == false);
+    }
+
+    SECTION("Shared mutexes support non-blocking and deadline locking in both modes")
+    {
+        mutex_guarded<int, std::shared_mutex> data{ 1 };
+
+        const auto readProxy = data.read_lock();
+
+        REQUIRE(data.try_read_lock().is_locked());
+        REQUIRE(data.try_with_read_lock_held_for(1ms, [](const int& value) { return value; }) == 1);
+
+        const auto wasWriteLocked = std::async(std::launch::async, [&] {
+                                        const auto deadline =
+                                            std::chrono::steady_clock::now() + 1ms;
+
+                                        return data.try_with_write_lock_held_until(
+                                            deadline, [](int& value) noexcept { ++value; });
+                                    }).get();
+
+        REQUIRE(wasWriteLocked == false);
+    }
+
+    SECTION("Shared timed mutexes use their native deadline support")
+    {
+        mutex_guarded<int, std::shared_timed_mutex> data{ 1 };
+
+        const auto writeProxy = data.write_lock();
+
+        const auto result = std::async(std::launch::async, [&] {
+                                const auto deadline = std::chrono::steady_clock::now() + 1ms;
+                                return data.try_read_lock_until(deadline).is_locked() ||
+                                       data.try_read_lock().is_locked();
+                            }).get();
+
+        REQUIRE(result == false);
+    }
+
+    SECTION("Shared timed mutexes run void functors under a timed shared lock")
+    {
+        mutex_guarded<int, std::shared_timed_mutex> data{ 1 };
+
+        auto value_seen = 0;
+        const auto read_value = [&](const int& value) { value_seen = value; };
+
+        // Succeeds only because the functor runs under a shared lock.
+        const auto readProxy = data.read_lock();
+
+        REQUIRE(std::as_const(data).try_with_read_lock_held_for(1ms, read_value));
+        REQUIRE(value_seen == 1);
+    }
+}
+
+TEST_CASE("Lock Proxy Ownership")
+{
+    using proxy_type = mutex_guarded<int>::unique_lock_proxy;
+
+    mutex_guarded<int> data{ 1 };
+
+    const auto is_free = [&] {
+        return std::async(std::launch::async, [&] { return data.try_lock().is_locked(); }).get();
+    };
+
+    SECTION("Proxies can be moved, but not copied")
+    {
+        STATIC_REQUIRE(std::is_copy_constructible_v<proxy_type> == false);
+        STATIC_REQUIRE(std::is_copy_assignable_v<proxy_type> == false);
+        STATIC_REQUIRE(std::is_nothrow_move_constructible_v<proxy_type>);
+        STATIC_REQUIRE(std::is_nothrow_move_assignable_v<proxy_type>);
+    }
+
+    SECTION("Moving a proxy transfers its lock")
+    {
+        auto first = data.lock();
+        auto second = std::move(first);
+
+        REQUIRE(first.is_locked() == false);
+        REQUIRE(second.is_locked());
+        REQUIRE(*second == 1);
+        REQUIRE(is_free() == false);
+
+        {
+            const auto third = std::move(second);
+        }
+
+        REQUIRE(is_free());
+    }
+
+    SECTION("Move-assigning a proxy releases the lock that it held before")
+    {
+        mutex_guarded<int> other{ 2 };
+
+        auto proxy = data.lock();
+        proxy = other.lock();
+
+        REQUIRE(*proxy == 2);
+        REQUIRE(is_free());
+    }
+
+    SECTION("Held locks can be stored and passed around")
+    {
+        std::vector<proxy_type> proxies;
+        proxies.push_back(data.lock());
+
+        REQUIRE(is_free() == false);
+
+        proxies.clear();
+        REQUIRE(is_free());
+    }
+
+    SECTION("A lock can be released early and reacquired")
+    {
+        auto proxy = data.lock();
+        *proxy = 2;
+
+        proxy.unlock();
+
+        REQUIRE(proxy.is_locked() == false);
+        REQUIRE(is_free());
+
+        proxy.relock();
+
+        REQUIRE(proxy.is_locked());
+        REQUIRE(*proxy == 2);
+        REQUIRE(is_free() == false);
+    }
+
+    SECTION("Reacquiring a lock can be attempted without blocking")
+    {
+        auto proxy = data.lock();
+        proxy.unlock();
+
+        {
+            const auto other = data.lock();
+
+            const auto was_relocked = std::async(std::launch::async, [&] {
+                                          return proxy.try_relock();
+                                      }).get();
+
+            REQUIRE(was_relocked == false);
+        }
+
+        REQUIRE(proxy.try_relock());
+    }
+
+    SECTION("A failed attempt to lock can be retried through the same proxy")
+    {
+        auto proxy = std::async(std::launch::async, [&] {
+                         const auto other = data.lock();
+                         return std::async(std::launch::async, [&] { return data.try_lock(); })
+                             .get();
+                     }).get();
+
+        REQUIRE(proxy.is_locked() == false);
+
+        proxy.relock();
+        REQUIRE(*proxy == 1);
+    }
+
+    SECTION("A deferred proxy doesn't acquire the lock until asked to")
+    {
+        proxy_type proxy{ &data, std::defer_lock };
+
+        REQUIRE(proxy.is_locked() == false);
+        REQUIRE(is_free());
+
+        REQUIRE(proxy.try_relock());
+        REQUIRE(is_free() == false);
+    }
+
+    SECTION("A released lock stays held until another proxy adopts it")
+    {
+        auto proxy = data.lock();
+        const auto token = proxy.release();
+
+        REQUIRE(proxy.is_locked() == false);
+        REQUIRE(is_free() == false);
+
+        {
+            const proxy_type adopted{ token };
+            REQUIRE(*adopted == 1);
+        }
+
+        REQUIRE(is_free());
+    }
+
+    SECTION("Guards without a spare bit in their address keep the lock state separately")
+    {
+        struct byte_mutex
+        {
+            void lock() noexcept
+            {
+                while (is_locked.exchange(true, std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            }
+
+            void unlock() noexcept
+            {
+                is_locked.store(false, std::memory_order_release);
+            }
+
+            std::atomic<bool> is_locked{ false };
+        };
+
+        mutex_guarded<char, byte_mutex> bytes{ 'a' };
+
+        auto proxy = bytes.lock();
+        proxy.unlock();
+        proxy.relock();
+
+        REQUIRE(*proxy == 'a');
+    }
+}
+
+TEST_CASE("Exchanging, Taking, and Swapping Data")
+{
+    using mutex_type = detail::wrapped_unique_mutex<std::mutex>;
+
+    SECTION("The data can be constructed in place")
+    {
+        const mutex_guarded<std::atomic<int>> data{ std::in_place, 42 };
+
+        REQUIRE(data.lock()->load() == 42);
+    }
+
+    SECTION("Exchanging the data returns the old value")
+    {
+        mutex_guarded<std::vector<int>> data{ std::vector<int>{ 1, 2, 3 } };
+
+        const auto old = data.exchange({ 4, 5 });
+
+        REQUIRE(old == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(*data.lock() == std::vector<int>{ 4, 5 });
+    }
+
+    SECTION("The old value is destroyed after the lock has been released")
+    {
+        auto was_unlocked_at_destruction = false;
+
+        mutex_guarded<detail::destruction_probe, mutex_type> data{
+            std::in_place, &was_unlocked_at_destruction
+        };
+
+        data.exchange(detail::destruction_probe{});
+
+        REQUIRE(detail::tracker.was_locked);
+        REQUIRE(was_unlocked_at_destruction);
+    }
+
+    SECTION("Taking the data leaves a default-constructed value behind")
+    {
+        mutex_guarded<std::vector<int>, mutex_type> data{ std::vector<int>{ 1, 2, 3 } };
+
+        const auto taken = data.take();
+
+        REQUIRE(taken == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(data.lock()->empty());
+    }
+
+    SECTION("Two guards can swap their data")
+    {
+        mutex_guarded<std::string> first{ "first" };
+        mutex_guarded<std::string> second{ "second" };
+
+        first.swap(second);
+
+        REQUIRE(*first.lock() == "second");
+        REQUIRE(*second.lock() == "first");
+
+        using std::swap;
+        swap(first, second);
+
+        REQUIRE(*first.lock() == "first");
+
+        first.swap(first);
+
+        REQUIRE(*first.lock() == "first");
+    }
+
+    SECTION("Assigning one guard to another returns the assigned-to guard")
+    {
+        mutex_guarded<std::string, std::shared_mutex> first{ "first" };
+        mutex_guarded<std::string, std::shared_mutex> second{ "second" };
+        mutex_guarded<std::string, std::shared_mutex> third{ "third" };
+
+        auto& assigned = (first = second);
+
+        REQUIRE(&assigned == &first);
+        REQUIRE(*first.read_lock() == "second");
+        REQUIRE(*second.read_lock() == "second");
+
+        auto& moved_to = (second = std::move(third));
+
+        REQUIRE(&moved_to == &second);
+        REQUIRE(*second.read_lock() == "third");
+
+        first = std::as_const(first);
+
+        REQUIRE(*first.read_lock() == "second");
+    }
+
+    SECTION("Assigning in opposite order from two threads doesn't deadlock")
+    {
+        mutex_guarded<int> first{ 1 };
+        mutex_guarded<int> second{ 1 };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 2; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int iteration = 0; iteration < 1'000; ++iteration) {
+                    if (thread == 0) {
+                        first = second;
+                    } else {
+                        second = first;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*first.lock() == 1);
+        REQUIRE(*second.lock() == 1);
+    }
+
+    SECTION("Swapping in opposite order from two threads doesn't deadlock")
+    {
+        mutex_guarded<int> first{ 1 };
+        mutex_guarded<int> second{ 2 };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 2; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (int iteration = 0; iteration < 1'000; ++iteration) {
+                    if (thread == 0) {
+                        first.swap(second);
+                    } else {
+                        second.swap(first);
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*first.lock() + *second.lock() == 3);
+    }
+
+    SECTION("Copying into an existing object reuses its storage")
+    {
+        const mutex_guarded<std::vector<int>> data{ std::vector<int>{ 1, 2, 3 } };
+
+        std::vector<int> snapshot;
+        snapshot.reserve(100);
+        const auto* const storage = snapshot.data();
+
+        data.copy_into(snapshot);
+
+        REQUIRE(snapshot == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(snapshot.data() == storage);
+    }
+
+    SECTION("Copying into an existing object only takes a shared lock, if possible")
+    {
+        mutex_guarded<int, std::shared_mutex> data{ 42 };
+
+        auto snapshot = 0;
+        auto status = std::future_status::timeout;
+
+        // Declared first, so that the lock is released before the future is waited on for good.
+        std::future<void> future;
+
+        {
+            const auto proxy = data.read_lock();
+
+            future = std::async(std::launch::async, [&] { data.copy_into(snapshot); });
+            status = future.wait_for(std::chrono::seconds{ 10 });
+        }
+
+        REQUIRE(status == std::future_status::ready);
+        REQUIRE(snapshot == 42);
+    }
+}
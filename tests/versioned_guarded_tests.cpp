@@ -0,0 +1,277 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <observable_guarded.h>
+#include <versioned_guarded.h>
+
+TEST_CASE("Versioning Policy")
+{
+    SECTION("Disabling versioning adds no state")
+    {
+        STATIC_REQUIRE(
+            sizeof(mutex_guarded<
+                   std::int64_t, std::mutex, compact_layout, no_statistics, no_notification,
+                   no_versioning>) == sizeof(mutex_guarded<std::int64_t, std::mutex>));
+    }
+
+    SECTION("Releasing a write lock advances the version")
+    {
+        versioned_guarded<int, std::shared_mutex> data{ 0 };
+
+        REQUIRE(data.version() == 0);
+
+        data.with_write_lock_held([](int& value) noexcept { ++value; });
+        *data.write_lock() = 2;
+
+        REQUIRE(data.version() == 2);
+    }
+
+    SECTION("Read-only proxies leave the version alone")
+    {
+        versioned_guarded<int, std::shared_mutex> shared{ 0 };
+
+        shared.with_read_lock_held([](const int&) noexcept {});
+        REQUIRE(*shared.read_lock() == 0);
+
+        versioned_guarded<int> unique{ 0 };
+
+        std::as_const(unique).with_lock_held([](const int&) noexcept {});
+        REQUIRE(*std::as_const(unique).lock() == 0);
+
+        REQUIRE(shared.version() == 0);
+        REQUIRE(unique.version() == 0);
+    }
+
+    SECTION("Releasing a write lock early advances the version right away")
+    {
+        versioned_guarded<int> data{ 0 };
+
+        auto proxy = data.lock();
+        proxy.unlock();
+
+        REQUIRE(data.version() == 1);
+
+        proxy.relock();
+        REQUIRE(data.version() == 1);
+    }
+}
+
+TEST_CASE("Optimistic Updates")
+{
+    versioned_guarded<std::vector<int>, std::shared_mutex> data{ std::vector<int>{ 1, 2, 3 } };
+
+    const auto sum = [](const std::vector<int>& values) {
+        return std::accumulate(values.begin(), values.end(), 0);
+    };
+
+    const auto append = [](std::vector<int>& values, int&& value) { values.push_back(value); };
+
+    SECTION("An uncontended update is committed on the first attempt")
+    {
+        auto attempts = 0;
+        const auto was_committed = data.update_optimistically(
+            [&](const std::vector<int>& values) {
+                ++attempts;
+                return sum(values);
+            },
+            append);
+
+        REQUIRE(was_committed);
+        REQUIRE(attempts == 1);
+        REQUIRE(*data.read_lock() == std::vector<int>{ 1, 2, 3, 6 });
+    }
+
+    SECTION("The computation runs without holding the lock")
+    {
+        std::size_t size_seen_by_other_thread = 0;
+
+        const auto was_committed = data.update_optimistically(
+            [&](const std::vector<int>& values) {
+                // This would deadlock if the lock were held exclusively.
+                std::thread{ [&] { size_seen_by_other_thread = data.write_lock()->size(); } }
+                    .join();
+
+                return sum(values);
+            },
+            append, 1);
+
+        REQUIRE(size_seen_by_other_thread == 3);
+        REQUIRE(was_committed == false);
+    }
+
+    SECTION("An update that was invalidated by a concurrent write is retried")
+    {
+        auto attempts = 0;
+        const auto was_committed = data.update_optimistically(
+            [&](const std::vector<int>& values) {
+                if (++attempts == 1) {
+                    std::thread{ [&] { data.write_lock()->push_back(4); } }.join();
+                }
+
+                return sum(values);
+            },
+            append);
+
+        REQUIRE(was_committed);
+        REQUIRE(attempts == 2);
+        REQUIRE(*data.read_lock() == std::vector<int>{ 1, 2, 3, 4, 10 });
+    }
+
+    SECTION("The number of attempts is bounded")
+    {
+        auto attempts = 0;
+        const auto was_committed = data.update_optimistically(
+            [&](const std::vector<int>& values) {
+                ++attempts;
+                std::thread{ [&] { data.write_lock()->push_back(0); } }.join();
+                return sum(values);
+            },
+            append, 3);
+
+        REQUIRE(was_committed == false);
+        REQUIRE(attempts == 3);
+        REQUIRE(data.read_lock()->size() == 6);
+    }
+
+    SECTION("A failed attempt doesn't count as a write")
+    {
+        observable_guarded<std::vector<int>, std::shared_mutex> observed{ std::vector<int>{ 1 } };
+
+        std::atomic<int> notifications{ 0 };
+        const auto subscription = observed.subscribe([&](std::uint64_t) { ++notifications; });
+
+        const auto version_before = observed.version();
+        const auto was_committed = observed.update_optimistically(
+            [&](const std::vector<int>& values) {
+                std::thread{ [&] { observed.write_lock()->push_back(2); } }.join();
+                return sum(values);
+            },
+            append, 1);
+
+        REQUIRE(was_committed == false);
+        REQUIRE(observed.version() == version_before + 1);
+        REQUIRE(notifications == 1);
+    }
+
+    SECTION("Concurrent optimistic updates are never lost")
+    {
+        versioned_guarded<int> counter{ 0 };
+        std::atomic<int> committed{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 1'000; ++iteration) {
+                    const auto was_committed = counter.update_optimistically(
+                        [](const int& value) { return value + 1; },
+                        [](int& value, int&& incremented) { value = incremented; });
+
+                    if (was_committed) {
+                        ++committed;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(*counter.lock() == committed.load());
+    }
+}
+
+TEST_CASE("Derived Values")
+{
+    versioned_guarded<std::vector<int>> data{ std::vector<int>{ 3, 1, 2 } };
+
+    auto computations = 0;
+    const auto sorted = data.derived([&](const std::vector<int>& values) {
+        ++computations;
+
+        auto copy = values;
+        std::sort(copy.begin(), copy.end());
+        return copy;
+    });
+
+    SECTION("The value is computed lazily, and only once while the data is unchanged")
+    {
+        REQUIRE(computations == 0);
+        REQUIRE(*sorted.get() == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(*sorted.get() == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(computations == 1);
+    }
+
+    SECTION("A current value is returned without locking the data")
+    {
+        REQUIRE(*sorted.get() == std::vector<int>{ 1, 2, 3 });
+
+        const auto proxy = data.lock();
+
+        const auto value = std::async(std::launch::async, [&] { return sorted.get(); }).get();
+
+        REQUIRE(*value == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(computations == 1);
+    }
+
+    SECTION("Releasing a write lock causes the value to be recomputed")
+    {
+        const auto before = sorted.get();
+
+        data.lock()->push_back(0);
+
+        REQUIRE(*sorted.get() == std::vector<int>{ 0, 1, 2, 3 });
+        REQUIRE(*before == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(computations == 2);
+    }
+
+    SECTION("A functor can be run on the value without taking a reference to it")
+    {
+        REQUIRE(sorted.with_value([](const std::vector<int>& values) { return values.front(); }) ==
+                1);
+
+        data.lock()->push_back(0);
+
+        REQUIRE(sorted.with_value([](const std::vector<int>& values) { return values.front(); }) ==
+                0);
+        REQUIRE(computations == 2);
+    }
+
+    SECTION("Concurrent readers share a single recomputation")
+    {
+        versioned_guarded<int, std::shared_mutex> counter{ 0 };
+        std::atomic<int> sums{ 0 };
+
+        const auto doubled = counter.derived([&](const int& value) {
+            ++sums;
+            return value * 2;
+        });
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 1'000; ++iteration) {
+                    const auto value = *doubled.get();
+                    static_cast<void>(value);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(sums.load() == 1);
+        REQUIRE(*doubled.get() == 0);
+    }
+}
@@ -0,0 +1,177 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <waitable_guarded.h>
+
+TEST_CASE("Waitable Guard with a std::mutex")
+{
+    waitable_guarded<std::deque<int>> queue;
+
+    SECTION("Waiting does not add state to the proxies")
+    {
+        STATIC_REQUIRE(
+            sizeof(waitable_guarded<int>::unique_lock_proxy) ==
+            sizeof(mutex_guarded<int>::unique_lock_proxy));
+    }
+
+    SECTION("Waiting for a predicate that already holds returns immediately")
+    {
+        queue.modify_and_notify_one([](std::deque<int>& values) {
+            values.push_back(1);
+            return true;
+        });
+
+        auto proxy = queue.lock();
+        proxy.wait([](const std::deque<int>& values) { return !values.empty(); });
+
+        REQUIRE(proxy.is_locked());
+        REQUIRE(proxy->front() == 1);
+    }
+
+    SECTION("A consumer is woken up by a producer")
+    {
+        auto consumer = std::async(std::launch::async, [&] {
+            auto proxy = queue.lock();
+            proxy.wait([](const std::deque<int>& values) { return !values.empty(); });
+
+            const auto value = proxy->front();
+            proxy->pop_front();
+            return value;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+
+        queue.modify_and_notify_one([](std::deque<int>& values) {
+            values.push_back(42);
+            return true;
+        });
+
+        REQUIRE(consumer.get() == 42);
+        REQUIRE(queue.lock()->empty());
+    }
+
+    SECTION("Waiting with a timeout reports whether the predicate held")
+    {
+        auto proxy = queue.lock();
+
+        const auto was_satisfied = proxy.wait_for(
+            std::chrono::milliseconds{ 5 },
+            [](const std::deque<int>& values) { return !values.empty(); });
+
+        REQUIRE(was_satisfied == false);
+        REQUIRE(proxy.is_locked());
+    }
+
+    SECTION("Unmodified data does not trigger a notification")
+    {
+        const auto was_modified = queue.modify_and_notify_all([](std::deque<int>& values) {
+            if (values.size() > 10) {
+                values.pop_front();
+                return true;
+            }
+
+            return false;
+        });
+
+        REQUIRE(was_modified == false);
+    }
+
+    SECTION("Many producers and consumers")
+    {
+        constexpr int items_per_producer = 1'000;
+
+        std::vector<std::future<int>> consumers;
+        for (int consumer = 0; consumer < 2; ++consumer) {
+            consumers.push_back(std::async(std::launch::async, [&] {
+                int sum = 0;
+                for (int item = 0; item < items_per_producer; ++item) {
+                    auto proxy = queue.lock();
+                    proxy.wait([](const std::deque<int>& values) { return !values.empty(); });
+
+                    sum += proxy->front();
+                    proxy->pop_front();
+                }
+
+                return sum;
+            }));
+        }
+
+        std::vector<std::future<void>> producers;
+        for (int producer = 0; producer < 2; ++producer) {
+            producers.push_back(std::async(std::launch::async, [&] {
+                for (int item = 0; item < items_per_producer; ++item) {
+                    queue.modify_and_notify_one([](std::deque<int>& values) {
+                        values.push_back(1);
+                        return true;
+                    });
+                }
+            }));
+        }
+
+        for (auto& producer : producers) {
+            producer.get();
+        }
+
+        int total = 0;
+        for (auto& consumer : consumers) {
+            total += consumer.get();
+        }
+
+        REQUIRE(total == 2 * items_per_producer);
+    }
+}
+
+TEST_CASE("Waitable Guard with a std::shared_timed_mutex")
+{
+    waitable_guarded<int, std::shared_timed_mutex> data{ 0 };
+
+    SECTION("Readers wait while holding a shared lock")
+    {
+        std::vector<std::future<int>> readers;
+        for (int reader = 0; reader < 2; ++reader) {
+            readers.push_back(std::async(std::launch::async, [&] {
+                const auto proxy = data.read_lock();
+                proxy.wait([](const int& value) { return value == 1; });
+                return *proxy;
+            }));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+
+        data.modify_and_notify_all([](int& value) {
+            value = 1;
+            return true;
+        });
+
+        for (auto& reader : readers) {
+            REQUIRE(reader.get() == 1);
+        }
+    }
+
+    SECTION("Proxies acquired with a timeout reacquire their lock without one")
+    {
+        auto proxy = data.try_write_lock_for(std::chrono::milliseconds{ 10 });
+        REQUIRE(proxy.is_locked());
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{ 5 };
+        const auto was_satisfied =
+            proxy.wait_until(deadline, [](const int& value) { return value == 1; });
+
+        REQUIRE(was_satisfied == false);
+        REQUIRE(proxy.is_locked());
+        *proxy = 2;
+    }
+
+    SECTION("Guards can still be copied")
+    {
+        const auto copy = data;
+        REQUIRE(*copy.read_lock() == 0);
+    }
+}
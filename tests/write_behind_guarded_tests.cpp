@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <write_behind_guarded.h>
+
+namespace
+{
+struct aggregates
+{
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::vector<int> history;
+};
+} // namespace
+
+TEST_CASE("Write-Behind Guard")
+{
+    write_behind_guarded<aggregates> data;
+
+    SECTION("Posted mutations are applied by the next lock holder")
+    {
+        data.post_with_lock_held([](aggregates& value) noexcept { ++value.count; });
+        data.post_with_lock_held([](aggregates& value) noexcept { value.sum += 5; });
+
+        const auto [count, sum] = data.with_lock_held([](const aggregates& value) {
+            return std::make_pair(value.count, value.sum);
+        });
+
+        REQUIRE(count == 1);
+        REQUIRE(sum == 5);
+    }
+
+    SECTION("Posted mutations are applied in order")
+    {
+        for (int index = 0; index < 100; ++index) {
+            data.post_with_lock_held(
+                [index](aggregates& value) { value.history.push_back(index); });
+        }
+
+        data.flush();
+
+        data.with_lock_held([](const aggregates& value) {
+            REQUIRE(value.history.size() == 100);
+            for (int index = 0; index < 100; ++index) {
+                REQUIRE(value.history[index] == index);
+            }
+        });
+    }
+
+    SECTION("Move-only callables can be posted")
+    {
+        auto increment = std::make_unique<std::uint64_t>(7);
+        data.post_with_lock_held(
+            [increment = std::move(increment)](aggregates& value) { value.sum += *increment; });
+
+        data.flush();
+        REQUIRE(data.with_lock_held([](const aggregates& value) { return value.sum; }) == 7);
+    }
+
+    SECTION("Flushing applies everything posted from many threads")
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&] {
+                for (int iteration = 0; iteration < 10'000; ++iteration) {
+                    data.post_with_lock_held([](aggregates& value) noexcept { ++value.count; });
+                }
+
+                data.flush();
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(data.with_lock_held([](const aggregates& value) { return value.count; }) == 40'000);
+    }
+
+    SECTION("A background thread drains the queue")
+    {
+        std::atomic<bool> was_applied{ false };
+
+        data.start_draining(std::chrono::milliseconds{ 1 });
+        data.post_with_lock_held([&](aggregates& value) noexcept {
+            ++value.count;
+            was_applied.store(true);
+        });
+
+        // Acquiring the lock would drain the queue as well, so only watch for the side effect.
+        for (int attempt = 0; attempt < 1'000 && !was_applied.load(); ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+
+        data.stop_draining();
+        REQUIRE(was_applied.load());
+    }
+}
+
+TEST_CASE("Write-Behind Guard applies pending mutations on destruction")
+{
+    STATIC_REQUIRE(std::is_nothrow_destructible_v<write_behind_guarded<std::uint64_t>>);
+
+    auto observed = std::make_shared<std::uint64_t>(0);
+
+    {
+        write_behind_guarded<std::uint64_t> data{ 0 };
+        data.post_with_lock_held([observed](std::uint64_t&) noexcept { ++*observed; });
+    }
+
+    REQUIRE(*observed == 1);
+}